@@ -1,12 +1,19 @@
 #pragma once
 
+#include <cdv/back_end/image_view.hpp>
+#include <cdv/back_end/output_sink.hpp>
+#include <cdv/back_end/png_encoder.hpp>
 #include <cdv/core/vec2.hpp>
 
 #include <cdv/core/units.hpp>
 
 #include <iosfwd>
+#include <memory>
+#include <span>
 #include <string>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 struct _cairo_surface;
 struct _cairo;
@@ -30,16 +37,18 @@ namespace cdv
 
 namespace cdv::back_end
 {
-    struct cairo_static_data
-    {
-        ~cairo_static_data();
-    };
-
     class cairo
     {
     public:
         cairo(const pixels width, const pixels height);
         cairo(const pixels width, const pixels height, std::ostream& os);
+        cairo(const pixels width, const pixels height, output_sink& sink);  // the sink has to outlive the back end
+
+        // Renders into a caller provided buffer of at least height * stride bytes that has to outlive the back
+        // end. The stride has to be at least image_stride(width).
+        cairo(const pixels width, const pixels height, unsigned char* data, const int stride);
+
+        [[nodiscard]] static int image_stride(const pixels width);
 
         void set_line_width(const pixels width);
         void set_line_properties(const elem::line_properties& properties);
@@ -50,6 +59,9 @@ namespace cdv::back_end
         void move_to(const pixel_pos pos);
         void line_to(const pixel_pos pos);
 
+        // starts a new sub path at the first position and adds a line to each of the others
+        void append_path(const std::span<const pixel_pos> positions);
+
         void arc(const pixel_pos center, const pixels radius, const radians angle0, const radians angle1);
 
         void stroke();
@@ -73,13 +85,24 @@ namespace cdv::back_end
         void pop_transformation();
 
         void to_png(const std::string& file_name);
+        void to_png(std::ostream& os);
+        void to_png(std::vector<unsigned char>& buffer);  // appends the encoded png to the buffer
+        void to_png(std::vector<unsigned char>& buffer, const png_options& options);
+
+        [[nodiscard]] image_view image() const;
+
+        void finish();
 
     private:
-        cairo_static_data static_data_;
+        std::unique_ptr<output_sink> own_sink_;
+        output_sink* sink_ = nullptr;
         std::unique_ptr<_cairo_surface, void (*)(_cairo_surface*)> surface_;
         std::unique_ptr<_cairo, void (*)(_cairo*)> cr_;
-        std::unique_ptr<_cairo_font_face, void (*)(_cairo_font_face*)> font_face_;
+
+        using font_face_ptr = std::unique_ptr<_cairo_font_face, void (*)(_cairo_font_face*)>;
+        std::unordered_map<FT_FaceRec_*, font_face_ptr> font_faces_;
 
         cairo(const pixels height, _cairo_surface* surface);
+        cairo(const pixels width, const pixels height, std::unique_ptr<output_sink> sink);
     };
 }
@@ -0,0 +1,14 @@
+#pragma once
+
+namespace cdv::back_end
+{
+    // Read only access to the pixels of a raster surface. Every pixel is a native endian 32 bit ARGB value
+    // with premultiplied alpha, the rows start at the top of the image and are stride bytes apart.
+    struct image_view
+    {
+        const unsigned char* data = nullptr;
+        int width = 0;
+        int height = 0;
+        int stride = 0;
+    };
+}
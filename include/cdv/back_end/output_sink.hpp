@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <iosfwd>
+#include <vector>
+
+namespace cdv::back_end
+{
+    // Collects the output of a vector back end in a buffer of up to buffer_size bytes and writes it to the stream in
+    // blocks. The buffer only grows as far as the output needs, so small documents don't pay for a large buffer. A
+    // failed write is remembered and reported by flush(), which throws, so that errors reach the caller instead of
+    // getting lost in a callback. A sink can be reused for any number of documents (one after the other), which
+    // keeps its buffer allocated.
+    class output_sink
+    {
+    public:
+        static constexpr size_t default_buffer_size = 256 * 1024;
+
+        explicit output_sink(std::ostream& os, const size_t buffer_size = default_buffer_size);
+        ~output_sink();
+
+        output_sink(const output_sink&) = delete;
+        output_sink& operator=(const output_sink&) = delete;
+
+        // returns false if the output can no longer be written
+        bool write(const char* data, const size_t size);
+        bool write(const unsigned char* data, const size_t size);
+
+        // writes the buffered output to the stream and throws if any write to the stream failed
+        void flush();
+
+        [[nodiscard]] bool failed() const { return failed_; }
+        [[nodiscard]] size_t bytes_written() const { return bytes_written_; }
+        [[nodiscard]] size_t num_flushes() const { return num_flushes_; }
+
+    private:
+        bool write_buffer();
+
+        std::ostream& os_;
+        size_t buffer_size_;
+        std::vector<char> buffer_;
+        size_t bytes_written_ = 0;
+        size_t num_flushes_ = 0;
+        bool failed_ = false;
+    };
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cdv/back_end/image_view.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace cdv::back_end
+{
+    // The filter that is applied to every row before compression. adaptive picks the filter with the smallest
+    // sum of absolute differences for each row (the heuristic that libpng uses by default).
+    enum class png_filter
+    {
+        none,
+        sub,
+        up,
+        average,
+        paeth,
+        adaptive
+    };
+
+    struct png_options
+    {
+        int compression_level = 6;  // zlib level, from 0 (store only) to 9 (smallest output)
+        png_filter filter = png_filter::adaptive;
+        size_t num_threads = 1;          // zero uses one thread per hardware thread
+        size_t chunk_size = 128 * 1024;  // uncompressed bytes that are filtered and deflated in one piece
+    };
+
+    // Encodes the pixels as an 8 bit RGBA png with straight alpha (like cairo's png writer does) and appends it to
+    // the buffer. With more than one thread the rows are split into chunks that are filtered and deflated
+    // concurrently and then joined into a single zlib stream. Every chunk uses the end of the previous one as its
+    // dictionary, so the output is only slightly larger than with a single thread.
+    void encode_png(const image_view& image, std::vector<unsigned char>& buffer, const png_options& options = {});
+}
@@ -0,0 +1,213 @@
+#pragma once
+
+#include <cdv/back_end/output_sink.hpp>
+#include <cdv/core/units.hpp>
+#include <cdv/core/vec2.hpp>
+
+#include <cstddef>
+#include <iosfwd>
+#include <memory>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+struct FT_FaceRec_;
+struct z_stream_s;
+
+namespace cdv
+{
+    namespace fnt
+    {
+        struct shaped_glyph;
+    }
+
+    namespace elem
+    {
+        struct line_properties;
+    }
+}
+
+namespace cdv::back_end
+{
+    struct svg_options
+    {
+        int precision = 3;                    // decimal places of coordinates (in pixels), from 0 to 6
+        bool relative_path_commands = false;  // also drops redundant command letters, separators and leading zeros
+        bool shared_styles = false;           // repeated fill and stroke attributes become css classes
+        bool merge_paths = false;             // consecutive paths with the same style are written as one element
+        bool gzip = false;                    // writes an svgz file
+
+        // smaller output that looks the same, merge_paths only merges paths if that doesn't change the result
+        [[nodiscard]] static constexpr svg_options compact()
+        {
+            return {.precision = 2, .relative_path_commands = true, .shared_styles = true, .merge_paths = true};
+        }
+    };
+
+    // A back end with the same interface as back_end::cairo that writes svg elements to the stream while the figure
+    // is being drawn instead of building up the whole document first. Transformations are applied to the coordinates
+    // directly, so the output only consists of paths, clip groups and glyphs. The outline of a glyph is defined the
+    // first time it is drawn and referenced from then on. The output is passed on to an output_sink in small blocks.
+    class svg
+    {
+    public:
+        svg(const pixels width, const pixels height, std::ostream& os, const svg_options& options = {});
+
+        // the sink has to outlive the back end
+        svg(const pixels width, const pixels height, output_sink& sink, const svg_options& options = {});
+        svg(svg&& other) noexcept;
+        svg& operator=(svg&&) = delete;
+        ~svg();
+
+        void set_line_width(const pixels width);
+        void set_line_properties(const elem::line_properties& properties);
+
+        void set_color(const double r, const double g, const double b, const double a);
+        void fill_background(const double r, const double g, const double b, const double a);
+
+        void move_to(const pixel_pos pos);
+        void line_to(const pixel_pos pos);
+        void append_path(const std::span<const pixel_pos> positions);
+
+        void arc(const pixel_pos center, const pixels radius, const radians angle0, const radians angle1);
+
+        void stroke();
+        void fill();
+
+        struct linear_gradient
+        {
+            pixel_pos start;
+            pixel_pos end;
+            std::string stops;
+        };
+
+        using fill_pattern_t = linear_gradient;
+        fill_pattern_t create_gradient(const pixels start, const pixels end);
+        void add_gradient_stop(fill_pattern_t& gradient, const double r, const double g, const double b, const double a,
+                               const double offset);
+        void set_fill_pattern(fill_pattern_t& pattern);
+        void unset_fill_pattern();
+
+        void set_clip_rect(const pixel_pos origin, const pixel_pos extents);
+        [[nodiscard]] std::pair<pixel_pos, pixel_pos> get_clip_rect() const;
+        void unset_clip_rect();
+
+        void set_font(FT_FaceRec_* ft_face, const pixels size);
+        void draw_glyphs(const std::vector<fnt::shaped_glyph>& glyphs);
+
+        void push_transformation(const pixel_pos translation, const radians rotation_angle, const vec2<double> scale);
+        void pop_transformation();
+
+        // Closes all open groups and the document and flushes the sink, which throws if writing to the stream
+        // failed. The document is completed (without flushing) in the destructor at the latest.
+        void finish();
+
+    private:
+        // maps (x, y) to (xx * x + xy * y + x0, yx * x + yy * y + y0) like a cairo_matrix_t
+        struct matrix
+        {
+            double xx = 1.0;
+            double yx = 0.0;
+            double xy = 0.0;
+            double yy = 1.0;
+            double x0 = 0.0;
+            double y0 = 0.0;
+        };
+
+        struct clip_rect
+        {
+            size_t id = 0;
+            pixel_pos min;  // bounding box in device coordinates
+            pixel_pos max;
+        };
+
+        struct graphics_state
+        {
+            matrix transformation;
+            std::string paint = "#000000";
+            double opacity = 1.0;
+            double line_width = 2.0;
+            std::string line_attributes = R"( stroke-miterlimit="10")";
+            std::vector<double> dashes;
+            std::vector<clip_rect> clip_rects;
+            FT_FaceRec_* font_face = nullptr;
+            double font_size = 0.0;
+        };
+
+        // the state of the path data that is needed to write the next command as short as possible
+        struct path_cursor
+        {
+            long long x = 0;  // the current point in units of the coordinate precision
+            long long y = 0;
+            char command = 0;  // the command that is repeated if the next one omits its letter
+            bool after_number = false;
+            bool after_decimal_point = false;
+        };
+
+        struct bounding_box
+        {
+            pixel_pos min;
+            pixel_pos max;
+        };
+
+        struct glyph_key_hash
+        {
+            size_t operator()(const std::pair<FT_FaceRec_*, size_t>& key) const;
+        };
+
+        [[nodiscard]] pixel_pos to_device(const pixel_pos pos) const;
+        [[nodiscard]] double device_scale() const;
+
+        [[nodiscard]] std::string to_coordinate(const double value) const;
+        void append_fixed(std::string& out, const long long value) const;
+        void append_command(std::string& out, path_cursor& cursor, const char command,
+                            const std::span<const long long> numbers) const;
+        void append_path_command(const char command, const std::span<const pixel_pos> device_points);
+        void append_point(const char command, const pixel_pos device_pos);
+        void append_curve(const pixel_pos control0, const pixel_pos control1, const pixel_pos end);
+        void write_path(const std::string& attributes, const bool is_fill);
+        [[nodiscard]] bool can_merge_path(const std::string& attributes, const bool is_fill) const;
+        void write_pending_path();
+        void append_paint(std::string& out, const char* attribute, const char* opacity_attribute) const;
+        [[nodiscard]] std::string style_attributes(const std::string& attributes);
+        void update_clip_groups();
+        void complete_document();
+        void flush_output(const size_t min_size);
+        void deflate_output(const bool finish);
+
+        svg(const pixels width, const pixels height, std::unique_ptr<output_sink> sink, const svg_options& options);
+
+        std::unique_ptr<output_sink> own_sink_;
+        output_sink* sink_;
+        pixels width_;
+        pixels height_;
+        svg_options options_;
+        double coordinate_scale_;
+
+        std::string out_;
+        std::string path_;
+        path_cursor path_cursor_;
+        std::string relative_command_;
+        bounding_box path_bounds_;
+        bool has_current_point_ = false;
+
+        // with merge_paths a path is only written once the next one can't be merged into it
+        std::string pending_attributes_;
+        std::string pending_path_;
+        std::vector<bounding_box> pending_bounds_;
+
+        std::unordered_map<std::string, size_t> style_classes_;
+        std::unique_ptr<z_stream_s, void (*)(z_stream_s*)> deflate_stream_;
+        std::vector<unsigned char> compressed_;
+
+        graphics_state state_;
+        std::vector<graphics_state> saved_states_;
+        std::vector<size_t> open_clip_groups_;
+
+        size_t next_id_ = 0;
+        std::unordered_map<std::pair<FT_FaceRec_*, size_t>, size_t, glyph_key_hash> glyph_ids_;
+        bool finished_ = false;
+    };
+}
@@ -1,9 +1,12 @@
 #pragma once
 
+#include <cdv/elem/detail/simplify_polyline.hpp>
 #include <cdv/elem/fill_properties.hpp>
+#include <cdv/elem/simplification_properties.hpp>
 #include <cdv/core/vec2.hpp>
 
 #include <range/v3/range/conversion.hpp>
+#include <range/v3/range/operations.hpp>
 #include <range/v3/view/concat.hpp>
 #include <range/v3/view/repeat_n.hpp>
 #include <range/v3/view/reverse.hpp>
@@ -17,6 +20,7 @@ namespace cdv::elem
         XRange xs;
         YRange ys;
         fill_properties fill;
+        simplification_properties simplification;
     };
 
     template <ranges::range XRange, ranges::range YRange, typename Surface>
@@ -24,37 +28,51 @@ namespace cdv::elem
     {
         using namespace units_literals;
         namespace rv = ::ranges::views;
-        surface.set_color(a.fill.color);
-        surface.draw_path(rv::zip_with(make_pos, a.xs, a.ys) | rv::reverse);
-        surface.fill();
+        const auto positions = rv::zip_with(make_pos, a.xs, a.ys) | rv::reverse;
+        const auto draw_fill_and_outline = [&](const auto& path) {
+            surface.set_color(a.fill.color);
+            surface.draw_path(path);
+            surface.fill();
 
-        if (a.fill.outline.width > 0_pt)
+            if (a.fill.outline.width > 0_pt)
+            {
+                surface.set_line_properties(a.fill.outline);
+                surface.draw_path(path);
+                surface.stroke();
+            }
+        };
+
+        if ((a.simplification.tolerance.value() > 0.0) || (a.simplification.statistics != nullptr))
+        {
+            draw_fill_and_outline(detail::simplify_path(positions | ranges::to_vector, ranges::distance(positions),
+                                                        a.simplification));
+        }
+        else
         {
-            surface.set_line_properties(a.fill.outline);
-            surface.draw_path(rv::zip_with(make_pos, a.xs, a.ys) | rv::reverse);
-            surface.stroke();
+            draw_fill_and_outline(positions);
         }
     }
 
     template <ranges::range XRange, ranges::range TopYRange, ranges::range BaseYRange>
     requires std::is_same_v<ranges::range_value_type_t<TopYRange>, ranges::range_value_type_t<BaseYRange>> auto
     fill_between(const XRange& xs, const TopYRange& top_ys, const BaseYRange& base_ys,
-                 const fill_properties& fill = {})
+                 const fill_properties& fill = {}, const simplification_properties& simplification = {})
     {
         auto all_xs = (xs | ranges::to_vector);
         all_xs.insert(all_xs.end(), all_xs.rbegin(), all_xs.rend());
         auto all_ys = top_ys | ranges::to_vector;
         all_ys.insert(all_ys.end(), ranges::rbegin(base_ys), ranges::rend(base_ys));
-        return area(all_xs, all_ys, fill);
+        return area(all_xs, all_ys, fill, simplification);
     }
 
     template <ranges::range XRange, ranges::range YRange, typename YType = ranges::range_value_type_t<YRange>>
-    auto fill_between(const XRange& xs, const YRange& ys, const YType& y, const fill_properties& fill = {})
+    auto fill_between(const XRange& xs, const YRange& ys, const YType& y, const fill_properties& fill = {},
+                      const simplification_properties& simplification = {})
     {
         auto all_xs = (xs | ranges::to_vector);
         all_xs.insert(all_xs.end(), {all_xs.back(), all_xs.front()});
         auto all_ys = ys | ranges::to_vector;
         all_ys.insert(all_ys.end(), {YType(y), YType(y)});
-        return area(all_xs, all_ys, fill);
+        return area(all_xs, all_ys, fill, simplification);
     }
 }
\ No newline at end of file
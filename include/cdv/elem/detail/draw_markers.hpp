@@ -3,6 +3,8 @@
 #include <cdv/elem/detail/draw_line_markers.hpp>
 #include <cdv/elem/detail/draw_polygonal_markers.hpp>
 #include <cdv/elem/detail/draw_round_markers.hpp>
+#include <cdv/elem/detail/viewport.hpp>
+#include <cdv/elem/line_properties.hpp>
 
 #include <range/v3/view/repeat.hpp>
 
@@ -45,8 +47,13 @@ namespace cdv::elem::detail
     {
         if (style == no_marker) return;
 
+        // markers that are outside of the clip rect are skipped, a marker is no larger than its size and the
+        // outline of line markers
+        const auto view = visible_viewport(surface, stroke_margin(surface.to_pixels(line_properties().width)));
         const auto draw_as = [&](const auto& draw_individual_marker) {
-            draw_all_markers(surface, positions, sizes, draw_individual_marker);
+            draw_all_markers(surface, positions, sizes, [&](const pixel_pos pos, const pixels size) {
+                if (view.contains(pos, size)) draw_individual_marker(pos, size);
+            });
         };
 
         if (style == '.')
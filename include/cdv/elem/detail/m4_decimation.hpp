@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cdv/core/vec2.hpp>
+#include <cdv/stdx/concepts.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace cdv::elem::detail
+{
+    // The columns are narrower than a pixel, so that the anti-aliased edges of a decimated line don't move
+    constexpr auto m4_columns_per_pixel = 4.0;
+
+    // Reduces every run of consecutive positions that fall into the same column to its first, lowest, highest and
+    // last position (the M4 aggregation). A line through the result covers the same pixels as a line through all
+    // of the positions, which for a series with many more positions than columns is a small fraction of them.
+    // Other column widths are only used to test that choice.
+    template <stdx::range_of<pixel_pos> Positions>
+    std::vector<pixel_pos> m4_decimate(const Positions& positions,
+                                       const double columns_per_pixel = m4_columns_per_pixel)
+    {
+        struct indexed_pos
+        {
+            pixel_pos pos;
+            size_t index = 0;
+        };
+
+        std::vector<pixel_pos> result;
+        auto column = std::array<indexed_pos, 4>{};  // first, lowest, highest, last
+        const auto append_column = [&] {
+            std::sort(column.begin(), column.end(), [](const auto& a, const auto& b) { return a.index < b.index; });
+            for (size_t i = 0; i < column.size(); ++i)
+            {
+                if ((i == 0) || (column[i].index != column[i - 1].index)) result.push_back(column[i].pos);
+            }
+        };
+
+        auto column_index = 0.0;
+        size_t index = 0;
+        for (const auto& pos : positions)
+        {
+            const auto c = std::floor(pos.x.value() * columns_per_pixel);
+            const auto p = indexed_pos{.pos = pos, .index = index++};
+            if ((p.index == 0) || (c != column_index))
+            {
+                if (p.index != 0) append_column();
+                column = {p, p, p, p};
+                column_index = c;
+            }
+            else
+            {
+                if (pos.y < column[1].pos.y) column[1] = p;
+                if (pos.y > column[2].pos.y) column[2] = p;
+                column[3] = p;
+            }
+        }
+
+        if (index != 0) append_column();
+        return result;
+    }
+}
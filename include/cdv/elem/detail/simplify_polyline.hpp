@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cdv/core/vec2.hpp>
+#include <cdv/elem/simplification_properties.hpp>
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace cdv::elem::detail
+{
+    [[nodiscard]] inline double squared_segment_distance(const pixel_pos pos, const pixel_pos start,
+                                                         const pixel_pos end)
+    {
+        const auto dx = (end.x - start.x).value();
+        const auto dy = (end.y - start.y).value();
+        const auto px = (pos.x - start.x).value();
+        const auto py = (pos.y - start.y).value();
+        const auto length_sq = dx * dx + dy * dy;
+        auto t = (length_sq > 0.0) ? (px * dx + py * dy) / length_sq : 0.0;
+        t = (t < 0.0) ? 0.0 : ((t > 1.0) ? 1.0 : t);
+        const auto ex = px - t * dx;
+        const auto ey = py - t * dy;
+        return ex * ex + ey * ey;
+    }
+
+    // Douglas-Peucker with an explicit stack, the first and last position are always kept
+    [[nodiscard]] inline std::vector<pixel_pos> simplify_polyline(const std::vector<pixel_pos>& positions,
+                                                                  const pixels tolerance)
+    {
+        if (positions.size() < 3) return positions;
+
+        const auto tolerance_sq = tolerance.value() * tolerance.value();
+        auto keep = std::vector<bool>(positions.size(), false);
+        keep.front() = true;
+        keep.back() = true;
+
+        auto segments = std::vector<std::pair<size_t, size_t>>{{0, positions.size() - 1}};
+        while (!segments.empty())
+        {
+            const auto [first, last] = segments.back();
+            segments.pop_back();
+
+            auto max_distance_sq = tolerance_sq;
+            auto farthest = first;
+            for (auto i = first + 1; i < last; ++i)
+            {
+                const auto distance_sq = squared_segment_distance(positions[i], positions[first], positions[last]);
+                if (distance_sq > max_distance_sq)
+                {
+                    max_distance_sq = distance_sq;
+                    farthest = i;
+                }
+            }
+
+            if (farthest != first)
+            {
+                keep[farthest] = true;
+                segments.emplace_back(first, farthest);
+                segments.emplace_back(farthest, last);
+            }
+        }
+
+        std::vector<pixel_pos> result;
+        for (size_t i = 0; i < positions.size(); ++i)
+        {
+            if (keep[i]) result.push_back(positions[i]);
+        }
+
+        return result;
+    }
+
+    // num_vertices is the vertex count of the element, which can be larger than path.size() after decimation
+    [[nodiscard]] inline std::vector<pixel_pos> simplify_path(std::vector<pixel_pos> path, const size_t num_vertices,
+                                                              const simplification_properties& properties)
+    {
+        if (properties.tolerance.value() > 0.0) path = simplify_polyline(path, properties.tolerance);
+        if (properties.statistics != nullptr)
+        {
+            properties.statistics->num_paths++;
+            properties.statistics->num_vertices_before += num_vertices;
+            properties.statistics->num_vertices_after += path.size();
+        }
+
+        return path;
+    }
+}
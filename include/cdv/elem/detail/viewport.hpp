@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cdv/core/units.hpp>
+#include <cdv/core/vec2.hpp>
+
+#include <range/v3/algorithm/all_of.hpp>
+#include <range/v3/range/access.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace cdv::elem::detail
+{
+    // cairo's default, which the svg back end uses as well
+    constexpr auto miter_limit = 10.0;
+
+    // The bounding box of the area of the surface that can be drawn on (the active clip rect, or the whole surface),
+    // extended by a margin. Anything outside of it doesn't have to be sent to the back end at all.
+    struct viewport
+    {
+        pixel_pos min;
+        pixel_pos max;
+
+        [[nodiscard]] bool contains(const pixel_pos pos, const pixels margin = pixels{}) const
+        {
+            return (pos.x >= min.x - margin) && (pos.x <= max.x + margin) && (pos.y >= min.y - margin) &&
+                   (pos.y <= max.y + margin);
+        }
+
+        // whether the bounding box of the two positions overlaps the viewport
+        [[nodiscard]] bool intersects(const pixel_pos a, const pixel_pos b) const
+        {
+            return (std::max(a.x, b.x) >= min.x) && (std::min(a.x, b.x) <= max.x) && (std::max(a.y, b.y) >= min.y) &&
+                   (std::min(a.y, b.y) <= max.y);
+        }
+    };
+
+    template <typename Surface>
+    [[nodiscard]] viewport visible_viewport(const Surface& surface, const pixels margin)
+    {
+        const auto [min, max] = surface.get_clip_rect();
+        return {.min = min - pixel_pos(margin, margin), .max = max + pixel_pos(margin, margin)};
+    }
+
+    // the distance from the path up to which a stroke with the given line width (in pixels) can draw
+    [[nodiscard]] inline pixels stroke_margin(const pixels line_width)
+    {
+        using namespace units_literals;
+        return 0.5 * miter_limit * line_width + 1_px;
+    }
+
+    // Draws the parts of the path that have a segment within the viewport as separate sub-paths. A stroke only
+    // looks different outside of the viewport, as long as its margin covers joins and caps, but dashes would start
+    // anew in every sub-path.
+    template <typename Surface, typename Positions>
+    void draw_visible_path(Surface& surface, const Positions& positions, const viewport& view)
+    {
+        if (ranges::all_of(positions, [&](const pixel_pos& pos) { return view.contains(pos); }))
+        {
+            surface.draw_path(positions);
+            return;
+        }
+
+        std::vector<pixel_pos> run;
+        auto it = ranges::begin(positions);
+        auto previous = *it;
+        for (++it; it != ranges::end(positions); ++it)
+        {
+            const pixel_pos pos = *it;
+            if (view.intersects(previous, pos))
+            {
+                if (run.empty()) run.push_back(previous);
+                run.push_back(pos);
+            }
+            else if (!run.empty())
+            {
+                surface.draw_path(run);
+                run.clear();
+            }
+
+            previous = pos;
+        }
+
+        if (!run.empty()) surface.draw_path(run);
+    }
+}
@@ -1,33 +1,72 @@
 #pragma once
 
 #include <cdv/core/units.hpp>
-#include <utility>
 #include <cdv/core/vec2.hpp>
+#include <cdv/elem/detail/m4_decimation.hpp>
+#include <cdv/elem/detail/simplify_polyline.hpp>
+#include <cdv/elem/detail/viewport.hpp>
 #include <cdv/elem/line_properties.hpp>
+#include <cdv/elem/simplification_properties.hpp>
 
 #include <range/v3/back.hpp>
 #include <range/v3/front.hpp>
+#include <range/v3/range/conversion.hpp>
+#include <range/v3/range/operations.hpp>
 #include <range/v3/view/zip_with.hpp>
 #include <utility>
 
 namespace cdv::elem
 {
+    // With m4 the points of a line are reduced to the first, lowest, highest and last point of every quarter pixel
+    // column before the line is drawn, which looks the same but is much faster for series with many more points
+    // than pixels. Dashed lines are always drawn with all points because the dashes depend on the path length.
+    enum class line_decimation
+    {
+        none,
+        m4
+    };
+
     template <stdx::range_of<pixels> XRange, stdx::range_of<pixels> YRange>
     struct line
     {
         XRange xs;
         YRange ys;
         line_properties properties;
+        line_decimation decimation = line_decimation::none;
+        simplification_properties simplification;
     };
 
     template <typename XRange, typename YRange>
-    line(const XRange&, const YRange&, line_properties = {}) -> line<XRange, YRange>;
+    line(const XRange&, const YRange&, line_properties = {}, line_decimation = {}, simplification_properties = {})
+        -> line<XRange, YRange>;
 
+    // segments of solid lines that are outside of the clip rect are left out, dashed lines are always drawn whole
     template <ranges::range XRange, ranges::range YRange, typename Surface>
     void draw(const line<XRange, YRange>& ln, Surface& surface, const pixel_pos&)
     {
         surface.set_line_properties(ln.properties);
-        surface.draw_path(ranges::views::zip_with(make_pos, ln.xs, ln.ys));
+        const auto positions = ranges::views::zip_with(make_pos, ln.xs, ln.ys);
+        const auto is_dashed = !ln.properties.style.dash_sequence.empty();
+        const auto view =
+            detail::visible_viewport(surface, detail::stroke_margin(surface.to_pixels(ln.properties.width)));
+        const auto draw_path = [&](const auto& path) {
+            if (is_dashed)
+                surface.draw_path(path);
+            else
+                detail::draw_visible_path(surface, path, view);
+        };
+
+        const auto decimate = (ln.decimation == line_decimation::m4) && !is_dashed;
+        if (decimate || (ln.simplification.tolerance.value() > 0.0) || (ln.simplification.statistics != nullptr))
+        {
+            auto path = decimate ? detail::m4_decimate(positions) : (positions | ranges::to_vector);
+            draw_path(detail::simplify_path(std::move(path), ranges::distance(positions), ln.simplification));
+        }
+        else
+        {
+            draw_path(positions);
+        }
+
         surface.stroke();
     }
 
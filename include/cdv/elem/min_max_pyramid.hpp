@@ -0,0 +1,217 @@
+#pragma once
+
+#include <cdv/core/units.hpp>
+#include <cdv/elem/detail/m4_decimation.hpp>
+#include <cdv/elem/line.hpp>
+#include <cdv/elem/line_properties.hpp>
+#include <cdv/stdx/concepts.hpp>
+
+#include <range/v3/range/conversion.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace cdv::elem
+{
+    // A series of samples with ascending x together with the position of the lowest and highest sample in every
+    // bucket of 2, 4, 8, ... consecutive samples. The lowest and highest sample of any index range are found in
+    // O(log(samples)), so a line for any x range drawn at any width needs O(columns * log(samples)) instead of
+    // O(samples), which makes repeatedly rendering sub-ranges of a long series (e.g. when zooming) cheap.
+    template <typename X, typename Y>
+    class min_max_pyramid
+    {
+    public:
+        template <stdx::range_of<X> XRange, stdx::range_of<Y> YRange>
+        min_max_pyramid(const XRange& xs, const YRange& ys) : xs_(xs | ranges::to_vector), ys_(ys | ranges::to_vector)
+        {
+            if (xs_.size() != ys_.size()) throw std::runtime_error("number of x and y values is different");
+            if (!std::is_sorted(xs_.begin(), xs_.end()))
+                throw std::runtime_error("x values are not in ascending order");
+
+            for (size_t size = ys_.size() / 2; size > 0; size /= 2)
+            {
+                auto level = std::vector<min_max>(size);
+                for (size_t i = 0; i < size; ++i)
+                {
+                    level[i] = levels_.empty() ? combine(sample(2 * i), sample(2 * i + 1))
+                                               : combine(levels_.back()[2 * i], levels_.back()[2 * i + 1]);
+                }
+
+                levels_.push_back(std::move(level));
+            }
+        }
+
+        [[nodiscard]] size_t size() const { return xs_.size(); }
+        [[nodiscard]] const std::vector<X>& xs() const { return xs_; }
+        [[nodiscard]] const std::vector<Y>& ys() const { return ys_; }
+
+        // indices of the lowest and highest sample with an index in [first, last), which must not be empty
+        [[nodiscard]] std::pair<size_t, size_t> min_max_indices(size_t first, const size_t last) const
+        {
+            if ((first >= last) || (last > size())) throw std::invalid_argument("invalid sample index range");
+
+            auto result = sample(first);
+            while (first < last)
+            {
+                // the largest bucket that starts at first and doesn't extend past last
+                const auto alignment = (first == 0) ? levels_.size() : size_t(std::countr_zero(first));
+                const auto level = std::min({alignment, size_t(std::bit_width(last - first)) - 1, levels_.size()});
+
+                result = combine(result, (level == 0) ? sample(first) : levels_[level - 1][first >> level]);
+                first += size_t(1) << level;
+            }
+
+            return {result.min, result.max};
+        }
+
+        // The indices of the samples with x in [x0, x1] that a line needs to look like the line through all of
+        // them: the first, lowest, highest and last sample of every column. The closest samples outside of the
+        // range are included as well, so that the line continues to the edges. column_of maps x to the column,
+        // which must not decrease with x.
+        template <typename ColumnOf>
+        [[nodiscard]] std::vector<size_t> select(const X& x0, const X& x1, const ColumnOf& column_of) const
+        {
+            auto first = static_cast<size_t>(std::lower_bound(xs_.begin(), xs_.end(), x0) - xs_.begin());
+            auto last = static_cast<size_t>(std::upper_bound(xs_.begin(), xs_.end(), x1) - xs_.begin());
+            if (first > 0) --first;
+            if (last < xs_.size()) ++last;
+
+            std::vector<size_t> result;
+            size_t column_size = 1;
+            while (first < last)
+            {
+                // the columns usually hold about as many samples as the previous one
+                const auto column = column_of(xs_[first]);
+                const auto end = column_end(first + 1, last, first + column_size,
+                                            [&](const X& x) { return column_of(x) <= column; });
+                column_size = end - first;
+
+                const auto [lowest, highest] = min_max_indices(first, end);
+                auto indices = std::array{first, lowest, highest, end - 1};
+                std::sort(indices.begin(), indices.end());
+                for (const auto i : indices)
+                {
+                    if (result.empty() || (result.back() != i)) result.push_back(i);
+                }
+
+                first = end;
+            }
+
+            return result;
+        }
+
+        // a line through the samples with x in [x0, x1] that is decimated to quarter pixel columns like
+        // line_decimation::m4, the scales map the samples to pixels
+        template <typename XScale, typename YScale>
+        [[nodiscard]] line<std::vector<pixels>, std::vector<pixels>> make_line(const X& x0, const X& x1,
+                                                                               const XScale& x_scale,
+                                                                               const YScale& y_scale,
+                                                                               line_properties properties = {}) const
+        {
+            const auto direction = (x_scale(x1) < x_scale(x0)) ? -1.0 : 1.0;
+            const auto indices = select(x0, x1, [&](const X& x) {
+                return std::floor(direction * x_scale(x).value() * detail::m4_columns_per_pixel);
+            });
+
+            auto result = line<std::vector<pixels>, std::vector<pixels>>();
+            result.properties = std::move(properties);
+            result.xs.reserve(indices.size());
+            result.ys.reserve(indices.size());
+            for (const auto i : indices)
+            {
+                result.xs.push_back(x_scale(xs_[i]));
+                result.ys.push_back(y_scale(ys_[i]));
+            }
+
+            return result;
+        }
+
+    private:
+        // the values are stored next to the indices so that a query doesn't have to look them up in ys_
+        struct min_max
+        {
+            size_t min = 0;
+            size_t max = 0;
+            Y min_y{};
+            Y max_y{};
+        };
+
+        // The first index in [lo, hi) with an x outside of the column, or hi. Starting at the guess, the range is
+        // narrowed down with steps of 1, 2, 4, ... before the binary search, so a good guess only takes a few probes.
+        template <typename InColumn>
+        [[nodiscard]] size_t column_end(size_t lo, size_t hi, const size_t guess, const InColumn& in_column) const
+        {
+            if (lo == hi) return lo;
+
+            auto i = std::clamp(guess, lo, hi - 1);
+            if (in_column(xs_[i]))
+            {
+                lo = i + 1;
+                for (size_t step = 1; lo < hi; step *= 2)
+                {
+                    i = std::min(lo + step - 1, hi - 1);
+                    if (!in_column(xs_[i]))
+                    {
+                        hi = i;
+                        break;
+                    }
+
+                    lo = i + 1;
+                }
+            }
+            else
+            {
+                hi = i;
+                for (size_t step = 1; lo < hi; step *= 2)
+                {
+                    i = (hi - lo > step) ? hi - step : lo;
+                    if (in_column(xs_[i]))
+                    {
+                        lo = i + 1;
+                        break;
+                    }
+
+                    hi = i;
+                }
+            }
+
+            return static_cast<size_t>(std::partition_point(xs_.begin() + lo, xs_.begin() + hi, in_column) -
+                                       xs_.begin());
+        }
+
+        [[nodiscard]] min_max sample(const size_t i) const { return {i, i, ys_[i], ys_[i]}; }
+
+        // ties are resolved in favour of the earlier sample
+        [[nodiscard]] static min_max combine(const min_max& a, const min_max& b)
+        {
+            auto result = a;
+            if (b.min_y < a.min_y)
+            {
+                result.min = b.min;
+                result.min_y = b.min_y;
+            }
+
+            if (a.max_y < b.max_y)
+            {
+                result.max = b.max;
+                result.max_y = b.max_y;
+            }
+
+            return result;
+        }
+
+        std::vector<X> xs_;
+        std::vector<Y> ys_;
+        std::vector<std::vector<min_max>> levels_;  // levels_[k] has the buckets of 2^(k+1) samples
+    };
+
+    template <typename XRange, typename YRange>
+    min_max_pyramid(const XRange&, const YRange&)
+        -> min_max_pyramid<ranges::range_value_t<XRange>, ranges::range_value_t<YRange>>;
+}
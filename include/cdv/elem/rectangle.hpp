@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cdv/elem/detail/draw_rectangle.hpp>
+#include <cdv/elem/detail/viewport.hpp>
 #include <cdv/elem/fill_properties.hpp>
 #include <cdv/core/vec2.hpp>
 
@@ -18,6 +19,9 @@ namespace cdv::elem
     void draw(const rectangle& r, Surface& surface, pixel_pos)
     {
         using namespace units_literals;
+        const auto margin = detail::stroke_margin(surface.to_pixels(r.fill.outline.width));
+        if (!detail::visible_viewport(surface, margin).intersects(r.min, r.max)) return;
+
         surface.set_color(r.fill.color);
         detail::fill_rectangle(surface, r.min, r.max, r.corner_radius);
 
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cdv/core/units.hpp>
+
+#include <cstddef>
+
+namespace cdv::elem
+{
+    struct simplification_statistics
+    {
+        size_t num_paths = 0;
+        size_t num_vertices_before = 0;
+        size_t num_vertices_after = 0;
+    };
+
+    // A tolerance above zero removes every vertex whose distance from the simplified path is at most the tolerance
+    // (Douglas-Peucker), which unlike line_decimation::m4 also works for paths that go back and forth in x.
+    struct simplification_properties
+    {
+        pixels tolerance{0.0};
+
+        // if set, the vertex counts of every path drawn with these properties are added to it
+        simplification_statistics* statistics = nullptr;
+    };
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cdv/back_end/cairo.hpp>
+#include <cdv/back_end/output_sink.hpp>
+#include <cdv/fig/draw.hpp>
+#include <cdv/fig/frame_dimensions.hpp>
+#include <cdv/fig/render_surface.hpp>
+#include <cdv/fnt/font_context.hpp>
+#include <cdv/stdx/parallel_for.hpp>
+
+#include <range/v3/range/access.hpp>
+#include <range/v3/range/concepts.hpp>
+#include <range/v3/range/primitives.hpp>
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace cdv::fig
+{
+    struct batch_options
+    {
+        size_t num_threads = 0;  // zero uses one thread per hardware thread
+        std::shared_ptr<fnt::font_context> context;  // null uses fnt::font_context::shared()
+
+        // Drawing text and finishing a vector output hold the lock of the font context, so workers that share a
+        // context wait for each other on text heavy figures. If a factory is given, every worker thread renders
+        // with its own context from it instead (e.g. with bundled_fonts_only and a font_cache_directory, so that
+        // setting up a context is cheap).
+        std::function<std::shared_ptr<fnt::font_context>()> context_factory;
+        std::optional<back_end::png_options> png;  // encodes pngs with back_end::encode_png instead of cairo
+    };
+
+    namespace detail
+    {
+        // The state of a thread that renders svgs, the stream and the sink (with its buffer) are reused for all
+        // the figures the thread renders
+        struct svg_batch_worker
+        {
+            explicit svg_batch_worker(std::shared_ptr<fnt::font_context> font_context)
+                : context(std::move(font_context))
+                , sink(os)
+            {
+            }
+
+            std::shared_ptr<fnt::font_context> context;
+            std::ostringstream os;
+            back_end::output_sink sink;
+        };
+
+        // Every thread creates a Worker from the font context it renders with before its first figure and passes
+        // it to render_figure(figure, index, worker) along with each figure
+        template <typename Worker, typename Figures, typename RenderFigure>
+        void render_batch(const Figures& figures, const batch_options& options, const RenderFigure& render_figure)
+        {
+            const auto num_figures = static_cast<size_t>(ranges::size(figures));
+            const auto first = ranges::begin(figures);
+
+            // the shared context is only set up when it is actually used, since that scans the system fonts
+            const auto context = (options.context || options.context_factory) ? options.context
+                                                                               : fnt::font_context::shared();
+            const auto make_worker = [&] {
+                return Worker(options.context_factory ? options.context_factory() : context);
+            };
+
+            stdx::parallel_for(num_figures, options.num_threads, make_worker, [&](Worker& worker, const size_t i) {
+                render_figure(*(first + static_cast<ranges::range_difference_t<Figures>>(i)), i, worker);
+            });
+        }
+    }
+
+    // Renders a whole range of figures on a pool of threads that share one font context, unless the options have
+    // a context factory. A figure is anything that can be drawn with draw(figure, surface, extents), e.g. a tuple
+    // of elements. Every finished figure is passed to sink(index, svg) on the thread that rendered it, so the sink
+    // has to be thread safe and the figures arrive in no particular order.
+    template <ranges::random_access_range Figures, typename Sink>
+    void render_batch_to_svg(const frame_dimensions& dimensions, const Figures& figures, const Sink& sink,
+                             const batch_options& options = {})
+    {
+        const auto extents = pixel_pos{dimensions.width, dimensions.height};
+        detail::render_batch<detail::svg_batch_worker>(
+            figures, options, [&](const auto& figure, const size_t index, detail::svg_batch_worker& worker) {
+                render_surface<back_end::cairo> surface(back_end::cairo(extents.x, extents.y, worker.sink),
+                                                        dimensions.dpi, worker.context);
+                draw(figure, surface, extents);
+                surface.finish();
+                auto svg = worker.os.str();
+                worker.os.str(std::string());
+                sink(index, std::move(svg));
+            });
+    }
+
+    template <ranges::random_access_range Figures>
+    std::vector<std::string> render_batch_to_svg_strings(const frame_dimensions& dimensions, const Figures& figures,
+                                                         const batch_options& options = {})
+    {
+        std::vector<std::string> result(static_cast<size_t>(ranges::size(figures)));
+        render_batch_to_svg(
+            dimensions, figures, [&](const size_t index, std::string svg) { result[index] = std::move(svg); }, options);
+        return result;
+    }
+
+    // The png equivalent of render_batch_to_svg - the sink receives the encoded png file contents
+    template <ranges::random_access_range Figures, typename Sink>
+    void render_batch_to_png(const frame_dimensions& dimensions, const Figures& figures, const Sink& sink,
+                             const batch_options& options = {})
+    {
+        const auto extents = pixel_pos{dimensions.width, dimensions.height};
+        detail::render_batch<std::shared_ptr<fnt::font_context>>(
+            figures, options, [&](const auto& figure, const size_t index, const auto& context) {
+                render_surface<back_end::cairo> surface(back_end::cairo(extents.x, extents.y), dimensions.dpi,
+                                                        context);
+                draw(figure, surface, extents);
+
+                std::vector<unsigned char> png;
+                if (options.png)
+                    surface.to_png(png, *options.png);
+                else
+                    surface.to_png(png);
+                sink(index, std::move(png));
+            });
+    }
+
+    template <ranges::random_access_range Figures>
+    std::vector<std::vector<unsigned char>> render_batch_to_png_buffers(const frame_dimensions& dimensions,
+                                                                        const Figures& figures,
+                                                                        const batch_options& options = {})
+    {
+        std::vector<std::vector<unsigned char>> result(static_cast<size_t>(ranges::size(figures)));
+        render_batch_to_png(
+            dimensions, figures,
+            [&](const size_t index, std::vector<unsigned char> png) { result[index] = std::move(png); }, options);
+        return result;
+    }
+}
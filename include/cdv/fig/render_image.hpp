@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cdv/back_end/cairo.hpp>
+#include <cdv/fig/draw.hpp>
+#include <cdv/fig/frame_dimensions.hpp>
+#include <cdv/fig/render_surface.hpp>
+
+#include <algorithm>
+
+namespace cdv::fig
+{
+    // The smallest row stride (in bytes) of a pixel buffer for a figure with the given dimensions
+    [[nodiscard]] inline int image_stride(const frame_dimensions& dimensions)
+    {
+        return back_end::cairo::image_stride(dimensions.width);
+    }
+
+    // Renders the elements straight into a caller provided ARGB32 buffer (see back_end::image_view for the pixel
+    // format) which has to hold at least dimensions.height * stride bytes. The buffer is cleared to transparent
+    // black first, so it can be reused from one figure to the next.
+    template <typename... Elements>
+    back_end::image_view render_to_image_buffer(unsigned char* data, const int stride,
+                                                const frame_dimensions& dimensions, const Elements&... elements)
+    {
+        const auto extents = pixel_pos{dimensions.width, dimensions.height};
+        std::fill_n(data, static_cast<size_t>(extents.y.value()) * static_cast<size_t>(stride), 0);
+
+        render_surface<back_end::cairo> surface(back_end::cairo(extents.x, extents.y, data, stride), dimensions.dpi);
+        (draw(elements, surface, extents), ...);
+        return surface.image();
+    }
+}
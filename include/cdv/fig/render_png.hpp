@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cdv/back_end/cairo.hpp>
+#include <cdv/fig/draw.hpp>
+#include <cdv/fig/frame_dimensions.hpp>
+#include <cdv/fig/render_surface.hpp>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace cdv::fig
+{
+    namespace detail
+    {
+        template <typename Write, typename... Elements>
+        void render_png(const Write& write, const frame_dimensions& dimensions, const Elements&... elements)
+        {
+            const auto extents = pixel_pos{dimensions.width, dimensions.height};
+            render_surface<back_end::cairo> surface(back_end::cairo(extents.x, extents.y), dimensions.dpi);
+            (draw(elements, surface, extents), ...);
+            write(surface);
+        }
+    }
+
+    template <typename... Elements>
+    void render_to_png_stream(std::ostream& os, const frame_dimensions& dimensions, const Elements&... elements)
+    {
+        detail::render_png([&](auto& surface) { surface.to_png(os); }, dimensions, elements...);
+    }
+
+    template <typename... Elements>
+    std::vector<unsigned char> render_to_png_buffer(const frame_dimensions& dimensions, const Elements&... elements)
+    {
+        std::vector<unsigned char> buffer;
+        detail::render_png([&](auto& surface) { surface.to_png(buffer); }, dimensions, elements...);
+        return buffer;
+    }
+
+    // Encodes the png with back_end::encode_png, which allows to trade compression for speed and to use several
+    // threads for large images
+    template <typename... Elements>
+    std::vector<unsigned char> render_to_png_buffer(const back_end::png_options& options,
+                                                    const frame_dimensions& dimensions, const Elements&... elements)
+    {
+        std::vector<unsigned char> buffer;
+        detail::render_png([&](auto& surface) { surface.to_png(buffer, options); }, dimensions, elements...);
+        return buffer;
+    }
+
+    template <typename... Elements>
+    void render_png(const std::string& file_name, const frame_dimensions& dimensions, const Elements&... elements)
+    {
+        detail::render_png([&](auto& surface) { surface.to_png(file_name); }, dimensions, elements...);
+    }
+}
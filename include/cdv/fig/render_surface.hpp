@@ -9,9 +9,14 @@
 #include <range/v3/algorithm/count.hpp>
 #include <range/v3/algorithm/transform.hpp>
 #include <range/v3/front.hpp>
+#include <range/v3/range/primitives.hpp>
 #include <range/v3/view/drop.hpp>
 #include <range/v3/view/enumerate.hpp>
 
+#include <iosfwd>
+#include <span>
+#include <vector>
+
 namespace cdv::fig
 {
     namespace detail
@@ -74,6 +79,11 @@ namespace cdv::fig
     public:
         render_surface(BackEnd&& back_end, const dots_per_inch dpi) : back_end_(std::move(back_end)), dpi_(dpi) {}
 
+        render_surface(BackEnd&& back_end, const dots_per_inch dpi, std::shared_ptr<fnt::font_context> context)
+            : text_shaper_(std::move(context)), back_end_(std::move(back_end)), dpi_(dpi)
+        {
+        }
+
         void set_color(const std::uint32_t hex_value)
         {
             const auto [r, g, b, a] = rgba_color(hex_value).as_doubles();
@@ -82,16 +92,29 @@ namespace cdv::fig
 
         void set_color(const rgba_color color) { set_color(color.as_uint32()); }
 
+        // The back end gets the whole path in a single call, positions that aren't stored contiguously (like the
+        // zipped x and y values of a line) are gathered in a buffer first
         void draw_path(const stdx::range_of<pixel_pos> auto& positions)
         {
             if (ranges::empty(positions)) return;
 
-            move_to(ranges::front(positions));
-            for (const auto& pos : ranges::views::drop(positions, 1))
-                line_to(pos);
+            using range_t = decltype(positions);
+            if constexpr (ranges::contiguous_range<range_t> && ranges::sized_range<range_t>)
+                back_end_.append_path(std::span(ranges::data(positions), ranges::size(positions)));
+            else
+            {
+                path_buffer_.clear();
+                for (const auto& pos : positions)
+                    path_buffer_.push_back(pos);
+
+                back_end_.append_path(path_buffer_);
+            }
         }
 
-        void draw_path(const std::initializer_list<pixel_pos> positions) { draw_path(ranges::views::all(positions)); }
+        void draw_path(const std::initializer_list<pixel_pos> positions)
+        {
+            back_end_.append_path(std::span(positions.begin(), positions.size()));
+        }
 
         void set_color_with_opacity(const rgba_color color, const double opacity)
         {
@@ -155,7 +178,7 @@ namespace cdv::fig
         {
             const auto shaped = text_shaper_.shape(text, font_size_, dpi_);
 
-            const auto vertical_extent = text_shaper_.shape("My", font_size_, dpi_).extents().y;
+            const auto vertical_extent = text_shaper_.vertical_extent(font_size_, dpi_);
 
             const auto anchor_x = static_cast<double>(x_anchor) / static_cast<double>(elem::horizontal_anchor::right);
             const auto anchor_y = static_cast<double>(y_anchor) / static_cast<double>(elem::vertical_anchor::top);
@@ -204,20 +227,44 @@ namespace cdv::fig
         [[nodiscard]] std::pair<pixel_pos, pixel_pos> get_clip_rect() const { return back_end_.get_clip_rect(); }
 
         void to_png(const std::string& file_name) { back_end_.to_png(file_name); }
+        void to_png(std::ostream& os) { back_end_.to_png(os); }
+        void to_png(std::vector<unsigned char>& buffer) { back_end_.to_png(buffer); }
+        template <typename Options>
+        void to_png(std::vector<unsigned char>& buffer, const Options& options)
+        {
+            back_end_.to_png(buffer, options);
+        }
+
+        [[nodiscard]] auto image() const { return back_end_.image(); }
+
+        // Completes the output of the back end. Vector back ends emit the glyph outlines at this point, so
+        // this needs the font lock just like drawing text does
+        void finish()
+        {
+            const auto lock = text_shaper_.context()->lock();
+            back_end_.finish();
+        }
 
         [[nodiscard]] pixels to_pixels(const points p) const { return mfl::points_to_pixels(p, dpi_); }
 
     private:
         void draw_shaped_text(const fnt::shaped_text& shaped)
         {
+            const auto lock = text_shaper_.context()->lock();
+            auto has_lines = false;
             for (const auto& run : shaped.runs())
             {
                 for (const auto& l : run.lines)
                 {
                     draw_path({l.min, {l.max.x, l.min.y}, l.max, {l.min.x, l.max.y}, l.min});
-                    fill();
+                    has_lines = true;
                 }
+            }
+
+            if (has_lines) fill();
 
+            for (const auto& run : shaped.runs())
+            {
                 fnt::freetype::set_size(run.freetype_face, run.font_size, dpi_);
                 back_end_.set_font(run.freetype_face, mfl::points_to_pixels(run.font_size, dpi_));
                 back_end_.draw_glyphs(run.glyphs);
@@ -226,6 +273,7 @@ namespace cdv::fig
 
         fnt::text_shaper text_shaper_;
         BackEnd back_end_;
+        std::vector<pixel_pos> path_buffer_;
         dots_per_inch dpi_{100};
         points font_size_{12};
     };
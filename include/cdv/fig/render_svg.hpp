@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cdv/back_end/cairo.hpp>
+#include <cdv/back_end/svg.hpp>
 #include <cdv/fig/draw.hpp>
 #include <cdv/fig/frame_dimensions.hpp>
 #include <cdv/fig/render_surface.hpp>
@@ -9,29 +10,66 @@
 #include <iostream>
 #include <string>
 #include <sstream>
+#include <utility>
 
 namespace cdv::fig
 {
-    template <typename... Elements>
+    namespace detail
+    {
+        template <typename BackEnd, typename... Elements>
+        void render_svg(BackEnd back_end, const frame_dimensions& dimensions, const Elements&... elements)
+        {
+            const auto extents = pixel_pos{dimensions.width, dimensions.height};
+            render_surface<BackEnd> surface(std::move(back_end), dimensions.dpi);
+            (draw(elements, surface, extents), ...);
+            surface.finish();
+        }
+    }
+
+    // The back end can be back_end::cairo or back_end::svg, which writes the svg elements directly to the stream
+    template <typename BackEnd = back_end::cairo, typename... Elements>
     void render_to_svg_stream(std::ostream& os, const frame_dimensions& dimensions, const Elements&... elements)
     {
-        const auto extents = pixel_pos{dimensions.width, dimensions.height};
-        render_surface<back_end::cairo> surface(back_end::cairo(extents.x, extents.y, os), dimensions.dpi);
-        (draw(elements, surface, extents), ...);
+        detail::render_svg(BackEnd(dimensions.width, dimensions.height, os), dimensions, elements...);
     }
 
+    // Renders with back_end::svg, e.g. with back_end::svg_options::compact() for smaller files
     template <typename... Elements>
+    void render_to_svg_stream(std::ostream& os, const back_end::svg_options& options,
+                              const frame_dimensions& dimensions, const Elements&... elements)
+    {
+        detail::render_svg(back_end::svg(dimensions.width, dimensions.height, os, options), dimensions, elements...);
+    }
+
+    template <typename BackEnd = back_end::cairo, typename... Elements>
     std::string render_to_svg_string(const frame_dimensions& dimensions, const Elements&... elements)
     {
         std::ostringstream os;
-        render_to_svg_stream(os, dimensions, elements...);
+        render_to_svg_stream<BackEnd>(os, dimensions, elements...);
         return os.str();
     }
 
-    template <typename... Elements>
+    template <typename BackEnd = back_end::cairo, typename... Elements>
     void render_svg(const std::string& file_name, const frame_dimensions& dimensions, const Elements&... elements)
     {
         std::ofstream os(file_name);
-        render_to_svg_stream(os, dimensions, elements...);
+        render_to_svg_stream<BackEnd>(os, dimensions, elements...);
+    }
+
+    template <typename... Elements>
+    std::string render_to_svg_string(const back_end::svg_options& options, const frame_dimensions& dimensions,
+                                     const Elements&... elements)
+    {
+        std::ostringstream os;
+        render_to_svg_stream(os, options, dimensions, elements...);
+        return os.str();
+    }
+
+    template <typename... Elements>
+    void render_svg(const std::string& file_name, const back_end::svg_options& options,
+                    const frame_dimensions& dimensions, const Elements&... elements)
+    {
+        std::ofstream os(file_name, std::ios::binary);
+        render_to_svg_stream(os, options, dimensions, elements...);
     }
 }
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cdv/fnt/freetype.hpp>
+#include <cdv/fnt/shaping_cache.hpp>
+
+#include <filesystem>
+#include <memory>
+#include <mutex>
+
+struct _FcConfig;
+
+namespace cdv::fnt
+{
+    class mfl_face_cache;
+
+    struct font_context_options
+    {
+        size_t shaped_text_cache_capacity = 4096;
+
+        // Only use the fonts that come with cdv instead of scanning all the system font directories. The
+        // fontconfig cache for those fonts is read from font_cache_directory (which defaults to a directory
+        // next to the fonts) and written there if it doesn't exist yet, so startup doesn't depend on the host
+        bool bundled_fonts_only = false;
+        std::filesystem::path font_cache_directory;
+    };
+
+    // Owns everything that is expensive to set up for text rendering - the fontconfig configuration (which
+    // requires a scan of the font directories), the FreeType library and all loaded faces. A context can be
+    // shared by any number of text shapers and render surfaces, also across threads. FreeType faces carry
+    // mutable state (e.g. the current char size), so all access to the faces and to the caches of a
+    // context must happen while holding the lock returned by lock().
+    class font_context
+    {
+    public:
+        explicit font_context(const font_context_options& options = {});
+        ~font_context();
+
+        font_context(const font_context&) = delete;
+        font_context& operator=(const font_context&) = delete;
+
+        [[nodiscard]] static std::shared_ptr<font_context> shared();
+
+        [[nodiscard]] std::unique_lock<std::mutex> lock() const { return std::unique_lock(mutex_); }
+
+        [[nodiscard]] const freetype& ft() const { return freetype_; }
+        [[nodiscard]] _FcConfig* fontconfig() const { return fc_config_.get(); }
+        [[nodiscard]] shaping_cache& cache() const { return cache_; }
+        [[nodiscard]] mfl_face_cache& math_faces() const { return *math_faces_; }
+
+    private:
+        std::unique_ptr<_FcConfig, void (*)(_FcConfig*)> fc_config_;
+        freetype freetype_;
+        mutable shaping_cache cache_;
+        std::unique_ptr<mfl_face_cache> math_faces_;
+        mutable std::mutex mutex_;
+    };
+}
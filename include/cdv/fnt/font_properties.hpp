@@ -15,6 +15,8 @@ namespace cdv::fnt
         font_slants slant = font_slants::normal;
         font_weights weight = font_weights::normal;
         font_stretches stretch = font_stretches::normal;
+
+        bool operator==(const font_properties&) const = default;
     };
 }
 
@@ -6,17 +6,26 @@
 #include FT_FREETYPE_H
 #include <mfl/font_family.hpp>
 
+#include <array>
 #include <filesystem>
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <utility>
-#include <vector>
+
+struct hb_font_t;
 
 namespace cdv::fnt
 {
+    class mapped_file;
+
     class freetype
     {
     public:
         freetype();
+        freetype(const freetype&) = delete;
+        freetype& operator=(const freetype&) = delete;
+        ~freetype();
 
         using library_t = std::remove_pointer_t<FT_Library>;
         using face_t = std::remove_pointer_t<FT_Face>;
@@ -27,17 +36,33 @@ namespace cdv::fnt
         using library_ptr = std::unique_ptr<library_t, decltype(&FT_Done_FreeType)>;
         using face_ptr = std::unique_ptr<face_t, decltype(&FT_Done_Face)>;
 
-        using face_cache_entry = std::pair<std::string, face_ptr>;
-        using face_cache = std::vector<face_cache_entry>;
+        // faces are created from memory mapped font files, so the entries keep the mapping alive for the face
+        struct face_cache_entry
+        {
+            std::shared_ptr<const mapped_file> file;
+            face_ptr face;
+        };
+
+        using face_key = std::pair<std::string, int>;
+
+        struct face_key_hash
+        {
+            size_t operator()(const face_key& key) const;
+        };
+
+        using face_cache = std::unordered_map<face_key, face_cache_entry, face_key_hash>;
 
         static void set_size(FT_Face ft_face, const points size, const dots_per_inch dpi);
+        [[nodiscard]] static hb_font_t* hb_font(FT_Face ft_face);
+        [[nodiscard]] static FT_Pos glyph_height(FT_Face ft_face, const FT_UInt glyph_index);
+
+        // A reference to a face (and to its library and font file) that keeps it alive after the freetype object
+        // that created it has been destroyed, for users that outlive it such as cairo's font caches
+        [[nodiscard]] static std::shared_ptr<face_t> share_face(FT_Face ft_face);
 
     private:
         library_ptr library_;
         mutable face_cache face_cache_;
-        face_ptr mfl_normal_face_;
-        face_ptr mfl_italic_face_;
-        face_ptr mfl_bold_face_;
-        face_ptr mfl_mono_face_;
+        mutable std::array<face_t*, 4> mfl_faces_ = {};  // loaded on first use, most charts have no math text
     };
 }
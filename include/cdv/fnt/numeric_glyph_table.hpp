@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace cdv::fnt
+{
+    // Pre-shaped glyphs for the characters that appear in numeric tick labels. The advance of a character
+    // depends on the character that follows it (kerning), so the table holds the advances of all pairs as
+    // they were shaped by HarfBuzz. Positions and advances are in 26.6 fixed point like the HarfBuzz output.
+    // A face whose pairs cannot be described this way (e.g. because of ligatures) is marked as unusable
+    // and numeric labels are shaped in full.
+    struct numeric_glyph_table
+    {
+        static constexpr std::string_view characters = "0123456789.-+e";
+        static constexpr auto num_characters = characters.size();
+
+        struct glyph
+        {
+            uint32_t index = 0;
+            int32_t x_offset = 0;
+            int32_t y_offset = 0;
+            int32_t advance = 0;
+        };
+
+        [[nodiscard]] static std::optional<size_t> slot(const char c)
+        {
+            const auto pos = characters.find(c);
+            return (pos == std::string_view::npos) ? std::nullopt : std::optional(pos);
+        }
+
+        [[nodiscard]] static bool is_numeric(const std::string_view text)
+        {
+            if (text.empty()) return false;
+
+            for (const auto c : text)
+                if (!slot(c)) return false;
+
+            return true;
+        }
+
+        bool usable = false;
+        std::array<glyph, num_characters> glyphs{};
+        std::array<std::array<int32_t, num_characters>, num_characters> pair_advances{};
+    };
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cdv/core/units.hpp>
+#include <cdv/core/vec2.hpp>
+#include <cdv/fnt/freetype.hpp>
+
+#include <vector>
+
+namespace cdv::fnt
+{
+    struct shaped_glyph
+    {
+        size_t index = 0;
+        pixel_pos pos{};
+    };
+
+    struct shaped_line
+    {
+        pixel_pos min;
+        pixel_pos max;
+    };
+
+    struct shaped_text_run
+    {
+        points font_size;
+        freetype::face_t* freetype_face;
+        std::vector<shaped_glyph> glyphs;
+        std::vector<shaped_line> lines;
+    };
+
+    class shaped_text
+    {
+    public:
+        [[nodiscard]] const std::vector<shaped_text_run>& runs() const { return runs_; }
+        [[nodiscard]] pixel_pos extents() const { return extents_; }
+
+    private:
+        friend class text_shaper;
+
+        std::vector<shaped_text_run> runs_;
+        pixel_pos extents_;
+    };
+}
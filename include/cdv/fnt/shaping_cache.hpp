@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cdv/core/units.hpp>
+#include <cdv/fnt/font_properties.hpp>
+#include <cdv/fnt/freetype.hpp>
+#include <cdv/fnt/numeric_glyph_table.hpp>
+#include <cdv/fnt/shaped_text.hpp>
+
+#include <list>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+namespace cdv::fnt
+{
+    struct cache_statistics
+    {
+        size_t hits = 0;
+        size_t misses = 0;
+    };
+
+    // how the texts that weren't found in the cache were shaped
+    struct shaping_counts
+    {
+        size_t numeric = 0;   // laid out from a numeric glyph table
+        size_t harfbuzz = 0;  // shaped by HarfBuzz (once for every part of a text outside of formulas)
+    };
+
+    // Remembers the results of text shaping. Shaped texts and the layouts of mathematical formulas are kept
+    // in a least recently used cache with a bounded number of entries. Formula layouts don't depend on the
+    // selected face and are positioned at the origin so they can be reused wherever the formula appears in
+    // a text. The faces selected for font properties, the vertical extents of the faces (which are used to
+    // anchor text) and the numeric glyph tables are only a handful of entries per face and are therefore
+    // never evicted.
+    class shaping_cache
+    {
+    public:
+        explicit shaping_cache(const size_t capacity);
+
+        [[nodiscard]] const shaped_text* find_text(const std::string_view text, const freetype::face_t* face,
+                                                   const points size, const dots_per_inch dpi);
+        void insert_text(const std::string_view text, const freetype::face_t* face, const points size,
+                         const dots_per_inch dpi, const shaped_text& shaped);
+
+        [[nodiscard]] const shaped_text* find_formula(const std::string_view formula, const points size,
+                                                      const dots_per_inch dpi);
+        void insert_formula(const std::string_view formula, const points size, const dots_per_inch dpi,
+                            const shaped_text& shaped);
+
+        [[nodiscard]] std::optional<pixels> find_vertical_extent(const freetype::face_t* face, const points size,
+                                                                 const dots_per_inch dpi);
+        void insert_vertical_extent(const freetype::face_t* face, const points size, const dots_per_inch dpi,
+                                    const pixels extent);
+
+        [[nodiscard]] freetype::face_t* find_face(const font_properties& properties, const points size);
+        void insert_face(const font_properties& properties, const points size, freetype::face_t* face);
+
+        [[nodiscard]] const numeric_glyph_table* find_numeric_glyphs(const freetype::face_t* face, const points size,
+                                                                     const dots_per_inch dpi) const;
+        const numeric_glyph_table& insert_numeric_glyphs(const freetype::face_t* face, const points size,
+                                                         const dots_per_inch dpi, const numeric_glyph_table& table);
+
+        [[nodiscard]] cache_statistics face_statistics() const { return face_statistics_; }
+        [[nodiscard]] cache_statistics text_statistics() const { return text_statistics_; }
+        [[nodiscard]] cache_statistics formula_statistics() const { return formula_statistics_; }
+        [[nodiscard]] cache_statistics vertical_extent_statistics() const { return vertical_extent_statistics_; }
+
+        void count_shaping(const bool numeric) { ++(numeric ? shaping_counts_.numeric : shaping_counts_.harfbuzz); }
+        [[nodiscard]] shaping_counts shaping_statistics() const { return shaping_counts_; }
+
+        [[nodiscard]] size_t size() const { return entries_.size(); }
+        [[nodiscard]] size_t capacity() const { return capacity_; }
+
+        void clear();
+
+    private:
+        struct face_size_key
+        {
+            const freetype::face_t* face = nullptr;
+            double size = 0.0;
+            double dpi = 0.0;
+
+            bool operator==(const face_size_key&) const = default;
+        };
+
+        struct face_size_key_hash
+        {
+            size_t operator()(const face_size_key& key) const;
+        };
+
+        struct face_selection_key
+        {
+            font_properties properties;
+            double size = 0.0;
+
+            bool operator==(const face_selection_key&) const = default;
+        };
+
+        struct face_selection_key_hash
+        {
+            size_t operator()(const face_selection_key& key) const;
+        };
+
+        // The index refers to the strings owned by the list entries so that lookups don't need to copy the text
+        struct text_key
+        {
+            std::string_view text;
+            face_size_key face_size;
+            bool is_formula = false;
+
+            bool operator==(const text_key&) const = default;
+        };
+
+        struct text_key_hash
+        {
+            size_t operator()(const text_key& key) const;
+        };
+
+        struct entry
+        {
+            std::string text;
+            face_size_key face_size;
+            bool is_formula = false;
+            shaped_text shaped;
+        };
+
+        using entry_list = std::list<entry>;
+
+        [[nodiscard]] const shaped_text* find(const text_key& key, cache_statistics& statistics);
+        void insert(const text_key& key, const shaped_text& shaped);
+
+        size_t capacity_;
+        entry_list entries_;
+        std::unordered_map<text_key, entry_list::iterator, text_key_hash> index_;
+        std::unordered_map<face_selection_key, freetype::face_t*, face_selection_key_hash> faces_;
+        std::unordered_map<face_size_key, pixels, face_size_key_hash> vertical_extents_;
+        std::unordered_map<face_size_key, numeric_glyph_table, face_size_key_hash> numeric_glyphs_;
+        cache_statistics face_statistics_;
+        cache_statistics text_statistics_;
+        cache_statistics formula_statistics_;
+        cache_statistics vertical_extent_statistics_;
+        shaping_counts shaping_counts_;
+    };
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace cdv::stdx
+{
+    template <typename T>
+    void hash_combine(std::size_t& seed, const T& value)
+    {
+        seed ^= std::hash<T>{}(value) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+    }
+
+    template <typename... Ts>
+    [[nodiscard]] std::size_t hash_values(const Ts&... values)
+    {
+        std::size_t seed = 0;
+        (hash_combine(seed, values), ...);
+        return seed;
+    }
+}
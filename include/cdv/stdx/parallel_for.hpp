@@ -0,0 +1,69 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cdv::stdx
+{
+    [[nodiscard]] inline size_t effective_num_threads(const size_t requested, const size_t num_tasks)
+    {
+        const auto available = (requested == 0) ? std::max(size_t(1), size_t(std::thread::hardware_concurrency()))
+                                                : requested;
+        return std::min(available, num_tasks);
+    }
+
+    // Calls f(state, i) for every i in [0, num_tasks) on up to num_threads threads (including the calling thread),
+    // where state is created by make_state() once per thread before its first task. Each thread takes the next
+    // unprocessed index from a shared counter when it is done with the previous one, so threads that get cheap
+    // tasks simply take more of them. The first exception thrown by make_state or f stops all threads from taking
+    // new tasks and is rethrown once all of them have finished.
+    template <typename MakeState, typename F>
+    void parallel_for(const size_t num_tasks, const size_t num_threads, const MakeState& make_state, const F& f)
+    {
+        std::atomic<size_t> next_task = 0;
+        std::exception_ptr error;
+        std::mutex error_mutex;
+
+        const auto work = [&] {
+            auto i = next_task++;
+            if (i >= num_tasks) return;
+
+            try
+            {
+                auto state = make_state();
+                for (; i < num_tasks; i = next_task++)
+                    f(state, i);
+            }
+            catch (...)
+            {
+                const auto lock = std::lock_guard(error_mutex);
+                if (!error) error = std::current_exception();
+                next_task = num_tasks;
+            }
+        };
+
+        const auto n = effective_num_threads(num_threads, num_tasks);
+        std::vector<std::thread> threads;
+        threads.reserve(n > 0 ? n - 1 : 0);
+        for (auto i = size_t(1); i < n; ++i)
+            threads.emplace_back(work);
+
+        work();
+        for (auto& thread : threads)
+            thread.join();
+
+        if (error) std::rethrow_exception(error);
+    }
+
+    // Calls f(i) for every i in [0, num_tasks), see above
+    template <typename F>
+    void parallel_for(const size_t num_tasks, const size_t num_threads, const F& f)
+    {
+        parallel_for(num_tasks, num_threads, [] { return nullptr; }, [&](std::nullptr_t, const size_t i) { f(i); });
+    }
+}
@@ -1,6 +1,8 @@
 #include <cdv/back_end/cairo.hpp>
 
+#include <back_end/dash_sequence.hpp>
 #include <cdv/elem/line_properties.hpp>
+#include <cdv/fnt/freetype.hpp>
 #include <cdv/fnt/text_shaper.hpp>
 #include <cdv/stdx/numbers.hpp>
 
@@ -8,29 +10,75 @@
 #include <cairo-svg.h>
 #include <cairo.h>
 #include <range/v3/algorithm/transform.hpp>
-#include <range/v3/view/enumerate.hpp>
 
 #include <iostream>
-#include <sstream>
+#include <memory>
+#include <stdexcept>
 
 namespace cdv::back_end
 {
     namespace
     {
-        cairo_surface_t* create_svg_surface(const pixels width, const pixels height, std::ostream& os)
+        // cairo's global caches (fonts, patterns, ...) are shared by all surfaces on all threads, so they are
+        // only released once at process exit, which keeps leak checkers quiet without pulling the caches
+        // from under other surfaces that are still rendering
+        struct cairo_static_data_guard
+        {
+            cairo_static_data_guard() = default;
+            cairo_static_data_guard(const cairo_static_data_guard&) = delete;
+            cairo_static_data_guard& operator=(const cairo_static_data_guard&) = delete;
+            ~cairo_static_data_guard() { cairo_debug_reset_static_data(); }
+        };
+
+        void reset_static_data_at_exit() { static const cairo_static_data_guard guard; }
+
+        // Cairo keeps font faces and the scaled fonts made from them in global caches that are keyed by the
+        // FreeType face and outlive the surface, so every font face holds a reference to its FreeType face.
+        // Otherwise a font context that is destroyed would leave a dangling face in the caches, which could even
+        // be found again by a new face at the same address.
+        void keep_face_alive(cairo_font_face_t* font_face, FT_Face ft_face)
+        {
+            static const cairo_user_data_key_t ft_face_key{};
+            if (cairo_font_face_get_user_data(font_face, &ft_face_key) != nullptr) return;
+
+            using shared_face = std::shared_ptr<fnt::freetype::face_t>;
+            auto* owner = new shared_face(fnt::freetype::share_face(ft_face));
+            if (cairo_font_face_set_user_data(font_face, &ft_face_key, owner,
+                                              [](void* data) { delete static_cast<shared_face*>(data); })
+                != CAIRO_STATUS_SUCCESS)
+            {
+                delete owner;
+                throw std::runtime_error("Failed to attach the FreeType face to the cairo font face");
+            }
+        }
+
+        cairo_surface_t* create_svg_surface(const pixels width, const pixels height, output_sink& sink)
         {
             const auto callback = [](void* closure, const unsigned char* data, unsigned int size) {
-                std::ostringstream& ostr = *reinterpret_cast<std::ostringstream*>(closure);
-                const auto* chars = reinterpret_cast<const std::ostringstream::char_type*>(data);
-                ostr.write(chars, size);  // TODO error handling
-                return CAIRO_STATUS_SUCCESS;
+                return static_cast<output_sink*>(closure)->write(data, size) ? CAIRO_STATUS_SUCCESS
+                                                                              : CAIRO_STATUS_WRITE_ERROR;
             };
 
-            auto* result = cairo_svg_surface_create_for_stream(callback, &os, width.value(), height.value());
+            auto* result = cairo_svg_surface_create_for_stream(callback, &sink, width.value(), height.value());
             cairo_svg_surface_set_document_unit(result, CAIRO_SVG_UNIT_PX);
             return result;
         }
 
+        cairo_surface_t* create_image_surface_for_data(const pixels width, const pixels height, unsigned char* data,
+                                                       const int stride)
+        {
+            auto* result = cairo_image_surface_create_for_data(data, CAIRO_FORMAT_ARGB32, static_cast<int>(width.value()),
+                                                               static_cast<int>(height.value()), stride);
+            if (const auto status = cairo_surface_status(result); status != CAIRO_STATUS_SUCCESS)
+            {
+                cairo_surface_destroy(result);
+                throw std::runtime_error(std::string("Failed to create image surface: ") +
+                                         cairo_status_to_string(status));
+            }
+
+            return result;
+        }
+
         cairo_line_join_t get_cairo_line_join(const elem::join_style join)
         {
             if (join == elem::join_style::bevel) return CAIRO_LINE_JOIN_BEVEL;
@@ -38,37 +86,20 @@ namespace cdv::back_end
             return CAIRO_LINE_JOIN_MITER;
         }
 
+        void check_png_status(const cairo_status_t status)
+        {
+            if (status != CAIRO_STATUS_SUCCESS)
+                throw std::runtime_error(std::string("Failed to write png: ") + cairo_status_to_string(status));
+        }
+
         cairo_line_cap_t get_cairo_line_cap(const elem::cap_style cap)
         {
             if (cap == elem::cap_style::square) return CAIRO_LINE_CAP_SQUARE;
             if (cap == elem::cap_style::round) return CAIRO_LINE_CAP_ROUND;
             return CAIRO_LINE_CAP_BUTT;
         }
-
-        std::vector<double> dash_sequence(const elem::line_properties& attributes)
-        {
-            auto dashes = attributes.style.dash_sequence;
-            if (attributes.cap != elem::cap_style::butt)
-            {
-                // in cairo the dash and gap lengths (which in plt are provided as a multiple of the line width) exclude
-                // the cap sizes (which have a radius of 1 as a multiple of the line width), so e.g. if you have
-                // dashes and gaps of length 4, then the two caps neighbouring a gap will fill in half of the gap and
-                // visually you end up with dashes of length 6 and gaps of length 2. To prevent that we subtract the
-                // space that the line caps occupy from the dashes and add it to the gaps
-                ranges::transform(ranges::views::enumerate(dashes), dashes.begin(), [&](const auto p) {
-                    const auto index = std::get<0>(p);
-                    auto result = std::get<1>(p);
-                    constexpr auto cap_radius = 1.0;
-                    return ((index % 2) == 0) ? std::max(0.0001, result - cap_radius) : result + cap_radius;
-                });
-            }
-
-            return dashes;
-        }
     }
 
-    cairo_static_data::~cairo_static_data() { cairo_debug_reset_static_data(); }
-
     cairo::cairo(const pixels width, const pixels height)
         : cairo(height, cairo_image_surface_create(CAIRO_FORMAT_ARGB32, static_cast<int>(width.value()),
                                                    static_cast<int>(height.value())))
@@ -76,15 +107,39 @@ namespace cdv::back_end
     }
 
     cairo::cairo(const pixels width, const pixels height, std::ostream& os)
-        : cairo(height, create_svg_surface(width, height, os))
+        : cairo(width, height, std::make_unique<output_sink>(os))
+    {
+    }
+
+    cairo::cairo(const pixels width, const pixels height, output_sink& sink)
+        : cairo(height, create_svg_surface(width, height, sink))
+    {
+        sink_ = &sink;
+    }
+
+    cairo::cairo(const pixels width, const pixels height, std::unique_ptr<output_sink> sink)
+        : cairo(width, height, *sink)
+    {
+        // the surface writes to the sink until it is destroyed, so the sink is destroyed after the surface
+        own_sink_ = std::move(sink);
+    }
+
+    cairo::cairo(const pixels width, const pixels height, unsigned char* data, const int stride)
+        : cairo(height, create_image_surface_for_data(width, height, data, stride))
     {
     }
 
+    int cairo::image_stride(const pixels width)
+    {
+        return cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, static_cast<int>(width.value()));
+    }
+
     cairo::cairo(const pixels height, cairo_surface_t* surface)
         : surface_(surface, cairo_surface_destroy)
         , cr_(cairo_create(surface_.get()), cairo_destroy)
-        , font_face_(nullptr, cairo_font_face_destroy)
     {
+        reset_static_data_at_exit();
+
         // this default transformation accounts for the fact that cairo views y = 0 to be at
         // the top of the page with y increasing downwards whereas in cdv it's the other way round
         cairo_translate(cr_.get(), 0.0, height.value());
@@ -117,6 +172,18 @@ namespace cdv::back_end
 
     void cairo::line_to(const pixel_pos pos) { cairo_line_to(cr_.get(), pos.x.value(), pos.y.value()); }
 
+    void cairo::append_path(const std::span<const pixel_pos> positions)
+    {
+        // cairo_append_path would also just call cairo_line_to for every element, but only after the whole path has
+        // been converted to cairo_path_data_t
+        if (positions.empty()) return;
+
+        auto* cr = cr_.get();
+        cairo_move_to(cr, positions.front().x.value(), positions.front().y.value());
+        for (const auto& pos : positions.subspan(1))
+            cairo_line_to(cr, pos.x.value(), pos.y.value());
+    }
+
     void cairo::arc(const pixel_pos center, const pixels radius, const radians angle0, const radians angle1)
     {
         if (angle0 < angle1)
@@ -167,8 +234,17 @@ namespace cdv::back_end
 
     void cairo::set_font(FT_Face ft_face, const pixels size)
     {
-        font_face_.reset(cairo_ft_font_face_create_for_ft_face(ft_face, 0));
-        cairo_set_font_face(cr_.get(), font_face_.get());
+        // reusing the same font face object for a given FreeType face allows cairo to keep the scaled font
+        // in the current state (and in its caches) instead of creating a new one whenever the font is set
+        auto it = font_faces_.find(ft_face);
+        if (it == font_faces_.end())
+        {
+            auto font_face = font_face_ptr(cairo_ft_font_face_create_for_ft_face(ft_face, 0), cairo_font_face_destroy);
+            keep_face_alive(font_face.get(), ft_face);
+            it = font_faces_.emplace(ft_face, std::move(font_face)).first;
+        }
+
+        cairo_set_font_face(cr_.get(), it->second.get());
         cairo_set_font_size(cr_.get(), size.value());
     }
 
@@ -192,6 +268,59 @@ namespace cdv::back_end
         cairo_show_glyphs(cr_.get(), cairo_glyphs.data(), static_cast<int>(cairo_glyphs.size()));
     }
 
-    void cairo::to_png(const std::string& file_name) { cairo_surface_write_to_png(surface_.get(), file_name.c_str()); }
+    void cairo::to_png(const std::string& file_name)
+    {
+        check_png_status(cairo_surface_write_to_png(surface_.get(), file_name.c_str()));
+    }
+
+    void cairo::to_png(std::ostream& os)
+    {
+        const auto callback = [](void* closure, const unsigned char* data, unsigned int size) {
+            auto& ostr = *static_cast<std::ostream*>(closure);
+            ostr.write(reinterpret_cast<const std::ostream::char_type*>(data), size);
+            return ostr ? CAIRO_STATUS_SUCCESS : CAIRO_STATUS_WRITE_ERROR;
+        };
+
+        check_png_status(cairo_surface_write_to_png_stream(surface_.get(), callback, &os));
+    }
+
+    void cairo::to_png(std::vector<unsigned char>& buffer)
+    {
+        const auto callback = [](void* closure, const unsigned char* data, unsigned int size) {
+            auto& buf = *static_cast<std::vector<unsigned char>*>(closure);
+            buf.insert(buf.end(), data, data + size);
+            return CAIRO_STATUS_SUCCESS;
+        };
+
+        check_png_status(cairo_surface_write_to_png_stream(surface_.get(), callback, &buffer));
+    }
+
+    void cairo::to_png(std::vector<unsigned char>& buffer, const png_options& options)
+    {
+        encode_png(image(), buffer, options);
+    }
+
+    image_view cairo::image() const
+    {
+        // make sure that all pending drawing operations have reached the pixels
+        cairo_surface_flush(surface_.get());
+
+        const auto* data = cairo_image_surface_get_data(surface_.get());
+        if (data == nullptr) throw std::runtime_error("Pixel data is only available for raster surfaces");
+
+        return {.data = data,
+                .width = cairo_image_surface_get_width(surface_.get()),
+                .height = cairo_image_surface_get_height(surface_.get()),
+                .stride = cairo_image_surface_get_stride(surface_.get())};
+    }
+
+    void cairo::finish()
+    {
+        cairo_surface_finish(surface_.get());
+        if (sink_ != nullptr) sink_->flush();
+
+        if (const auto status = cairo_surface_status(surface_.get()); status != CAIRO_STATUS_SUCCESS)
+            throw std::runtime_error(std::string("Failed to finish surface: ") + cairo_status_to_string(status));
+    }
 
 }
\ No newline at end of file
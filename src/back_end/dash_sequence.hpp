@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cdv/elem/line_properties.hpp>
+
+#include <range/v3/algorithm/transform.hpp>
+#include <range/v3/view/enumerate.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace cdv::back_end
+{
+    // The dash and gap lengths of a line as a multiple of the line width, adjusted for the line caps
+    inline std::vector<double> dash_sequence(const elem::line_properties& attributes)
+    {
+        auto dashes = attributes.style.dash_sequence;
+        if (attributes.cap != elem::cap_style::butt)
+        {
+            // in cairo and svg the dash and gap lengths (which in plt are provided as a multiple of the line width)
+            // exclude the cap sizes (which have a radius of 1 as a multiple of the line width), so e.g. if you have
+            // dashes and gaps of length 4, then the two caps neighbouring a gap will fill in half of the gap and
+            // visually you end up with dashes of length 6 and gaps of length 2. To prevent that we subtract the
+            // space that the line caps occupy from the dashes and add it to the gaps
+            ranges::transform(ranges::views::enumerate(dashes), dashes.begin(), [&](const auto p) {
+                const auto index = std::get<0>(p);
+                auto result = std::get<1>(p);
+                constexpr auto cap_radius = 1.0;
+                return ((index % 2) == 0) ? std::max(0.0001, result - cap_radius) : result + cap_radius;
+            });
+        }
+
+        return dashes;
+    }
+}
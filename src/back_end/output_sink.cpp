@@ -0,0 +1,66 @@
+#include <cdv/back_end/output_sink.hpp>
+
+#include <algorithm>
+#include <ostream>
+#include <stdexcept>
+
+namespace cdv::back_end
+{
+    output_sink::output_sink(std::ostream& os, const size_t buffer_size)
+        : os_(os)
+        , buffer_size_(std::max(buffer_size, size_t(1)))
+    {
+    }
+
+    output_sink::~output_sink() { write_buffer(); }
+
+    bool output_sink::write(const char* data, const size_t size)
+    {
+        if (failed_) return false;
+
+        if (buffer_.size() + size > buffer_size_)
+        {
+            if (!write_buffer()) return false;
+
+            // blocks that are larger than the buffer go straight to the stream
+            if (size >= buffer_size_)
+            {
+                os_.write(data, static_cast<std::streamsize>(size));
+                bytes_written_ += size;
+                ++num_flushes_;
+                failed_ = !os_;
+                return !failed_;
+            }
+        }
+
+        if (buffer_.size() + size > buffer_.capacity())
+            buffer_.reserve(std::min(buffer_size_, std::max(2 * buffer_.capacity(), buffer_.size() + size)));
+
+        buffer_.insert(buffer_.end(), data, data + size);
+        return true;
+    }
+
+    bool output_sink::write(const unsigned char* data, const size_t size)
+    {
+        return write(reinterpret_cast<const char*>(data), size);
+    }
+
+    void output_sink::flush()
+    {
+        if (write_buffer()) os_.flush();
+        if (failed_ || !os_) throw std::runtime_error("Failed to write to the output stream");
+    }
+
+    bool output_sink::write_buffer()
+    {
+        if (failed_) return false;
+        if (buffer_.empty()) return true;
+
+        os_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        bytes_written_ += buffer_.size();
+        buffer_.clear();
+        ++num_flushes_;
+        failed_ = !os_;
+        return !failed_;
+    }
+}
@@ -0,0 +1,312 @@
+#include <cdv/back_end/png_encoder.hpp>
+
+#include <cdv/stdx/parallel_for.hpp>
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+namespace cdv::back_end
+{
+    namespace
+    {
+        constexpr size_t bytes_per_pixel = 4;
+        constexpr size_t deflate_window_size = 32768;
+        constexpr size_t max_idat_size = 1024 * 1024;
+
+        void append_u32(std::vector<unsigned char>& buffer, const uint32_t value)
+        {
+            buffer.push_back(static_cast<unsigned char>(value >> 24));
+            buffer.push_back(static_cast<unsigned char>(value >> 16));
+            buffer.push_back(static_cast<unsigned char>(value >> 8));
+            buffer.push_back(static_cast<unsigned char>(value));
+        }
+
+        void append_chunk(std::vector<unsigned char>& buffer, const char* type, const unsigned char* data,
+                          const size_t size)
+        {
+            append_u32(buffer, static_cast<uint32_t>(size));
+            const auto type_pos = buffer.size();
+            buffer.insert(buffer.end(), type, type + 4);
+            buffer.insert(buffer.end(), data, data + size);
+            append_u32(buffer, static_cast<uint32_t>(crc32(0, buffer.data() + type_pos, static_cast<uInt>(size + 4))));
+        }
+
+        // cairo stores premultiplied native endian ARGB pixels whereas png wants straight alpha RGBA bytes
+        void unpremultiply_row(const unsigned char* src, const size_t width, unsigned char* dst)
+        {
+            for (size_t x = 0; x < width; ++x, src += bytes_per_pixel, dst += bytes_per_pixel)
+            {
+                uint32_t pixel = 0;
+                std::memcpy(&pixel, src, sizeof(pixel));
+
+                const auto alpha = pixel >> 24;
+                const auto red = (pixel >> 16) & 0xff;
+                const auto green = (pixel >> 8) & 0xff;
+                const auto blue = pixel & 0xff;
+                if (alpha == 0xff)
+                {
+                    dst[0] = static_cast<unsigned char>(red);
+                    dst[1] = static_cast<unsigned char>(green);
+                    dst[2] = static_cast<unsigned char>(blue);
+                }
+                else if (alpha == 0)
+                {
+                    dst[0] = dst[1] = dst[2] = 0;
+                }
+                else
+                {
+                    dst[0] = static_cast<unsigned char>((red * 255 + alpha / 2) / alpha);
+                    dst[1] = static_cast<unsigned char>((green * 255 + alpha / 2) / alpha);
+                    dst[2] = static_cast<unsigned char>((blue * 255 + alpha / 2) / alpha);
+                }
+                dst[3] = static_cast<unsigned char>(alpha);
+            }
+        }
+
+        int paeth_predictor(const int a, const int b, const int c)
+        {
+            const auto p = a + b - c;
+            const auto pa = std::abs(p - a);
+            const auto pb = std::abs(p - b);
+            const auto pc = std::abs(p - c);
+            if ((pa <= pb) && (pa <= pc)) return a;
+            return (pb <= pc) ? b : c;
+        }
+
+        // Writes the filter type byte followed by the filtered row. prev is the unfiltered previous row (all zeros
+        // for the first row) and a, b, c are the left, upper and upper left neighbours of a byte as in the png spec.
+        template <typename Predictor>
+        void filter_row(const png_filter filter, const unsigned char* row, const unsigned char* prev, const size_t size,
+                        unsigned char* out, const Predictor& predictor)
+        {
+            out[0] = static_cast<unsigned char>(filter);
+            for (size_t i = 0; i < size; ++i)
+            {
+                const int a = (i >= bytes_per_pixel) ? row[i - bytes_per_pixel] : 0;
+                const int c = (i >= bytes_per_pixel) ? prev[i - bytes_per_pixel] : 0;
+                out[i + 1] = static_cast<unsigned char>(row[i] - predictor(a, prev[i], c));
+            }
+        }
+
+        void filter_row(const png_filter filter, const unsigned char* row, const unsigned char* prev, const size_t size,
+                        unsigned char* out)
+        {
+            switch (filter)
+            {
+                case png_filter::sub:
+                    filter_row(filter, row, prev, size, out, [](const int a, int, int) { return a; });
+                    break;
+                case png_filter::up:
+                    filter_row(filter, row, prev, size, out, [](int, const int b, int) { return b; });
+                    break;
+                case png_filter::average:
+                    filter_row(filter, row, prev, size, out, [](const int a, const int b, int) { return (a + b) / 2; });
+                    break;
+                case png_filter::paeth:
+                    filter_row(filter, row, prev, size, out, paeth_predictor);
+                    break;
+                default:
+                    out[0] = static_cast<unsigned char>(png_filter::none);
+                    std::copy_n(row, size, out + 1);
+            }
+        }
+
+        size_t sum_of_absolute_differences(const unsigned char* filtered, const size_t size)
+        {
+            size_t sum = 0;
+            for (size_t i = 0; i < size; ++i)
+                sum += static_cast<size_t>(std::abs(static_cast<int>(static_cast<signed char>(filtered[i]))));
+
+            return sum;
+        }
+
+        // Filters the rows [first_row, last_row) into out, which holds a filter type byte and the filtered bytes
+        // for every row
+        void filter_rows(const image_view& image, const png_filter filter, const size_t first_row,
+                         const size_t last_row, unsigned char* out)
+        {
+            const auto width = static_cast<size_t>(image.width);
+            const auto row_size = width * bytes_per_pixel;
+            std::vector<unsigned char> prev(row_size, 0);
+            std::vector<unsigned char> row(row_size);
+            std::vector<unsigned char> candidate(row_size + 1);
+
+            const auto source_row = [&](const size_t y) { return image.data + y * static_cast<size_t>(image.stride); };
+            if (first_row > 0) unpremultiply_row(source_row(first_row - 1), width, prev.data());
+
+            for (auto y = first_row; y < last_row; ++y, out += row_size + 1)
+            {
+                unpremultiply_row(source_row(y), width, row.data());
+                if (filter != png_filter::adaptive)
+                {
+                    filter_row(filter, row.data(), prev.data(), row_size, out);
+                }
+                else
+                {
+                    filter_row(png_filter::none, row.data(), prev.data(), row_size, out);
+                    auto best = sum_of_absolute_differences(out + 1, row_size);
+                    for (const auto f : {png_filter::sub, png_filter::up, png_filter::average, png_filter::paeth})
+                    {
+                        filter_row(f, row.data(), prev.data(), row_size, candidate.data());
+                        if (const auto sum = sum_of_absolute_differences(candidate.data() + 1, row_size); sum < best)
+                        {
+                            best = sum;
+                            std::copy(candidate.begin(), candidate.end(), out);
+                        }
+                    }
+                }
+
+                std::swap(row, prev);
+            }
+        }
+
+        // A raw deflate stream (without zlib header and checksum), these are added when the chunks are joined
+        class deflater
+        {
+        public:
+            explicit deflater(const int level)
+            {
+                if (deflateInit2(&stream_, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+                    throw std::runtime_error("Failed to initialize png compression");
+            }
+
+            ~deflater() { deflateEnd(&stream_); }
+
+            deflater(const deflater&) = delete;
+            deflater& operator=(const deflater&) = delete;
+
+            void set_dictionary(const unsigned char* data, const size_t size)
+            {
+                if (deflateSetDictionary(&stream_, data, static_cast<uInt>(size)) != Z_OK)
+                    throw std::runtime_error("Failed to set the png compression dictionary");
+            }
+
+            void compress(const unsigned char* data, const size_t size, const int flush,
+                          std::vector<unsigned char>& out)
+            {
+                stream_.next_in = const_cast<unsigned char*>(data);
+                stream_.avail_in = static_cast<uInt>(size);
+                for (;;)
+                {
+                    const auto produced = out.size();
+                    const size_t bound = deflateBound(&stream_, size);
+                    out.resize(produced + std::max(size_t(16 * 1024), bound));
+                    stream_.next_out = out.data() + produced;
+                    stream_.avail_out = static_cast<uInt>(out.size() - produced);
+
+                    const auto status = deflate(&stream_, flush);
+                    out.resize(out.size() - stream_.avail_out);
+                    if (status == Z_STREAM_END) return;
+                    if ((status != Z_OK) && (status != Z_BUF_ERROR)) throw std::runtime_error("Failed to compress png");
+                    if ((flush != Z_FINISH) && (stream_.avail_in == 0) && (stream_.avail_out != 0)) return;
+                }
+            }
+
+        private:
+            z_stream stream_ = {};
+        };
+
+        std::array<unsigned char, 2> zlib_header(const int level)
+        {
+            const auto level_flag = (level < 2) ? 0 : (level < 6) ? 1 : (level == 6) ? 2 : 3;
+            const auto cmf = 0x78;  // deflate with a 32K window
+            auto flg = level_flag << 6;
+            flg += 31 - ((cmf * 256 + flg) % 31);
+            return {static_cast<unsigned char>(cmf), static_cast<unsigned char>(flg)};
+        }
+
+        struct compressed_chunk
+        {
+            std::vector<unsigned char> data;
+            uLong adler = 1;
+            size_t size = 0;
+        };
+    }
+
+    void encode_png(const image_view& image, std::vector<unsigned char>& buffer, const png_options& options)
+    {
+        if ((image.data == nullptr) || (image.width <= 0) || (image.height <= 0))
+            throw std::runtime_error("Cannot encode an empty image as png");
+
+        const auto level = std::clamp(options.compression_level, 0, 9);
+        const auto height = static_cast<size_t>(image.height);
+        const auto filtered_row_size = static_cast<size_t>(image.width) * bytes_per_pixel + 1;
+        const auto rows_per_chunk = std::max(size_t(1), options.chunk_size / filtered_row_size);
+        const auto num_chunks = (height + rows_per_chunk - 1) / rows_per_chunk;
+        const auto num_threads = stdx::effective_num_threads(options.num_threads, num_chunks);
+        const auto chunk_begin = [&](const size_t chunk) { return std::min(chunk * rows_per_chunk, height); };
+
+        std::vector<unsigned char> filtered(height * filtered_row_size);
+        stdx::parallel_for(num_chunks, num_threads, [&](const size_t chunk) {
+            const auto first_row = chunk_begin(chunk);
+            filter_rows(image, options.filter, first_row, chunk_begin(chunk + 1),
+                        filtered.data() + first_row * filtered_row_size);
+        });
+
+        std::vector<compressed_chunk> chunks(num_chunks);
+        if (num_threads == 1)
+        {
+            // a single stream compresses slightly better than independent chunks
+            deflater stream(level);
+            for (size_t chunk = 0; chunk < num_chunks; ++chunk)
+            {
+                const auto* data = filtered.data() + chunk_begin(chunk) * filtered_row_size;
+                const auto size = (chunk_begin(chunk + 1) - chunk_begin(chunk)) * filtered_row_size;
+                stream.compress(data, size, (chunk + 1 == num_chunks) ? Z_FINISH : Z_NO_FLUSH, chunks.front().data);
+                chunks[chunk].adler = adler32(1, data, static_cast<uInt>(size));
+                chunks[chunk].size = size;
+            }
+        }
+        else
+        {
+            stdx::parallel_for(num_chunks, num_threads, [&](const size_t chunk) {
+                const auto offset = chunk_begin(chunk) * filtered_row_size;
+                const auto size = (chunk_begin(chunk + 1) - chunk_begin(chunk)) * filtered_row_size;
+                deflater stream(level);
+                if (offset > 0)
+                {
+                    const auto dictionary_size = std::min(offset, deflate_window_size);
+                    stream.set_dictionary(filtered.data() + offset - dictionary_size, dictionary_size);
+                }
+
+                // the sync flush ends each chunk on a byte boundary so that the chunks can simply be concatenated
+                auto& result = chunks[chunk];
+                stream.compress(filtered.data() + offset, size, (chunk + 1 == num_chunks) ? Z_FINISH : Z_SYNC_FLUSH,
+                                result.data);
+                result.adler = adler32(1, filtered.data() + offset, static_cast<uInt>(size));
+                result.size = size;
+            });
+        }
+
+        const auto header = zlib_header(level);
+        std::vector<unsigned char> zlib_stream(header.begin(), header.end());
+        auto adler = adler32(0, nullptr, 0);
+        for (const auto& chunk : chunks)
+        {
+            zlib_stream.insert(zlib_stream.end(), chunk.data.begin(), chunk.data.end());
+            adler = adler32_combine(adler, chunk.adler, static_cast<z_off_t>(chunk.size));
+        }
+        append_u32(zlib_stream, static_cast<uint32_t>(adler));
+
+        constexpr auto signature = std::array<unsigned char, 8>{0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+        buffer.insert(buffer.end(), signature.begin(), signature.end());
+
+        std::vector<unsigned char> ihdr;
+        append_u32(ihdr, static_cast<uint32_t>(image.width));
+        append_u32(ihdr, static_cast<uint32_t>(image.height));
+        // 8 bits per channel, RGBA, deflate, adaptive filtering, no interlacing
+        ihdr.insert(ihdr.end(), {8, 6, 0, 0, 0});
+        append_chunk(buffer, "IHDR", ihdr.data(), ihdr.size());
+
+        for (size_t pos = 0; pos < zlib_stream.size(); pos += max_idat_size)
+            append_chunk(buffer, "IDAT", zlib_stream.data() + pos, std::min(max_idat_size, zlib_stream.size() - pos));
+
+        append_chunk(buffer, "IEND", nullptr, 0);
+    }
+}
@@ -0,0 +1,820 @@
+#include <cdv/back_end/svg.hpp>
+
+#include <back_end/dash_sequence.hpp>
+#include <cdv/elem/line_properties.hpp>
+#include <cdv/fnt/shaped_text.hpp>
+#include <cdv/stdx/hash.hpp>
+#include <cdv/stdx/numbers.hpp>
+
+#include <fmt/format.h>
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include FT_OUTLINE_H
+#include <zlib.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+
+namespace cdv::back_end
+{
+    namespace
+    {
+        constexpr size_t output_block_size = 16 * 1024;
+        constexpr size_t max_merged_paths = 256;
+        constexpr auto powers_of_ten = std::array<long long, 7>{1, 10, 100, 1000, 10000, 100000, 1000000};
+
+        // coordinates are written with a precision of 1/1000 pixel, which is more than enough for any viewer
+        void append_number(std::string& out, const double value)
+        {
+            auto rounded = std::round(value * 1000.0) / 1000.0;
+            if (rounded == 0.0) rounded = 0.0;  // no "-0"
+            fmt::format_to(std::back_inserter(out), "{}", rounded);
+        }
+
+        std::string to_number(const double value)
+        {
+            std::string result;
+            append_number(result, value);
+            return result;
+        }
+
+        // transformation factors are relative, so they keep a fixed number of significant digits instead
+        std::string to_factor(const double value)
+        {
+            return (std::abs(value) < 1e-9) ? std::string("0") : fmt::format("{:.6g}", value);
+        }
+
+        std::string to_hex_color(const double r, const double g, const double b)
+        {
+            const auto channel = [](const double c) {
+                return static_cast<int>(std::lround(std::clamp(c, 0.0, 1.0) * 255.0));
+            };
+            return fmt::format("#{:02x}{:02x}{:02x}", channel(r), channel(g), channel(b));
+        }
+
+        // the attributes of a style are written as ' name="value"' pairs, which map directly to css properties
+        std::string to_css(const std::string& attributes)
+        {
+            std::string result;
+            for (auto pos = attributes.find('='); pos != std::string::npos; pos = attributes.find('=', pos))
+            {
+                const auto name_start = attributes.rfind(' ', pos) + 1;
+                const auto value_end = attributes.find('"', pos + 2);
+                result.append(attributes, name_start, pos - name_start).push_back(':');
+                result.append(attributes, pos + 2, value_end - pos - 2).push_back(';');
+                pos = value_end;
+            }
+
+            if (!result.empty()) result.pop_back();
+            return result;
+        }
+
+        z_stream_s* create_deflate_stream()
+        {
+            auto* stream = new z_stream{};
+            if (deflateInit2(stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, MAX_WBITS + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+            {
+                delete stream;
+                throw std::runtime_error("Failed to initialize the svgz compression");
+            }
+
+            return stream;
+        }
+
+        void destroy_deflate_stream(z_stream_s* stream)
+        {
+            if (stream == nullptr) return;
+
+            deflateEnd(stream);
+            delete stream;
+        }
+
+        const char* to_svg_line_cap(const elem::cap_style cap)
+        {
+            if (cap == elem::cap_style::square) return "square";
+            if (cap == elem::cap_style::round) return "round";
+            return nullptr;
+        }
+
+        const char* to_svg_line_join(const elem::join_style join)
+        {
+            if (join == elem::join_style::bevel) return "bevel";
+            if (join == elem::join_style::round) return "round";
+            return nullptr;
+        }
+
+        // glyph outlines are written in font units with y pointing upwards
+        struct outline_writer
+        {
+            std::string& out;
+            bool has_contour = false;
+
+            void append_point(const char command, const FT_Vector* p)
+            {
+                out.push_back(command);
+                append_number(out, static_cast<double>(p->x));
+                out.push_back(' ');
+                append_number(out, static_cast<double>(p->y));
+            }
+
+            static outline_writer& get(void* user) { return *static_cast<outline_writer*>(user); }
+
+            static int move_to(const FT_Vector* to, void* user)
+            {
+                auto& writer = get(user);
+                if (writer.has_contour) writer.out.push_back('Z');
+                writer.has_contour = true;
+                writer.append_point('M', to);
+                return 0;
+            }
+
+            static int line_to(const FT_Vector* to, void* user)
+            {
+                get(user).append_point('L', to);
+                return 0;
+            }
+
+            static int conic_to(const FT_Vector* control, const FT_Vector* to, void* user)
+            {
+                auto& writer = get(user);
+                writer.append_point('Q', control);
+                writer.append_point(' ', to);
+                return 0;
+            }
+
+            static int cubic_to(const FT_Vector* control0, const FT_Vector* control1, const FT_Vector* to, void* user)
+            {
+                auto& writer = get(user);
+                writer.append_point('C', control0);
+                writer.append_point(' ', control1);
+                writer.append_point(' ', to);
+                return 0;
+            }
+        };
+
+        void append_glyph_outline(std::string& out, FT_Face face, const size_t glyph_index)
+        {
+            constexpr auto flags = FT_LOAD_NO_SCALE | FT_LOAD_NO_BITMAP | FT_LOAD_NO_HINTING;
+            if (FT_Load_Glyph(face, static_cast<FT_UInt>(glyph_index), flags) != 0) return;
+            if (face->glyph->format != FT_GLYPH_FORMAT_OUTLINE) return;
+
+            const auto funcs = FT_Outline_Funcs{.move_to = outline_writer::move_to,
+                                                .line_to = outline_writer::line_to,
+                                                .conic_to = outline_writer::conic_to,
+                                                .cubic_to = outline_writer::cubic_to,
+                                                .shift = 0,
+                                                .delta = 0};
+            auto writer = outline_writer{.out = out};
+            FT_Outline_Decompose(&face->glyph->outline, &funcs, &writer);
+            if (writer.has_contour) out.push_back('Z');
+        }
+    }
+
+    size_t svg::glyph_key_hash::operator()(const std::pair<FT_FaceRec_*, size_t>& key) const
+    {
+        return stdx::hash_values(key.first, key.second);
+    }
+
+    svg::svg(const pixels width, const pixels height, std::ostream& os, const svg_options& options)
+        : svg(width, height, std::make_unique<output_sink>(os), options)
+    {
+    }
+
+    svg::svg(const pixels width, const pixels height, std::unique_ptr<output_sink> sink, const svg_options& options)
+        : svg(width, height, *sink, options)
+    {
+        own_sink_ = std::move(sink);
+    }
+
+    svg::svg(const pixels width, const pixels height, output_sink& sink, const svg_options& options)
+        : sink_(&sink)
+        , width_(width)
+        , height_(height)
+        , options_(options)
+        , deflate_stream_(options.gzip ? create_deflate_stream() : nullptr, destroy_deflate_stream)
+    {
+        options_.precision = std::clamp(options.precision, 0, static_cast<int>(powers_of_ten.size()) - 1);
+        coordinate_scale_ = static_cast<double>(powers_of_ten[size_t(options_.precision)]);
+        if (deflate_stream_) compressed_.resize(output_block_size);
+
+        // like with cairo y = 0 is at the bottom of the figure and y increases upwards
+        state_.transformation = {.yy = -1.0, .y0 = height.value()};
+
+        out_ = R"(<?xml version="1.0" encoding="UTF-8"?>)"
+               "\n"
+               R"(<svg xmlns="http://www.w3.org/2000/svg" xmlns:xlink="http://www.w3.org/1999/xlink")";
+        fmt::format_to(std::back_inserter(out_), R"( width="{0}px" height="{1}px" viewBox="0 0 {0} {1}">)",
+                       to_number(width.value()), to_number(height.value()));
+        out_.push_back('\n');
+    }
+
+    svg::svg(svg&& other) noexcept
+        : own_sink_(std::move(other.own_sink_))
+        , sink_(std::exchange(other.sink_, nullptr))
+        , width_(other.width_)
+        , height_(other.height_)
+        , options_(other.options_)
+        , coordinate_scale_(other.coordinate_scale_)
+        , out_(std::move(other.out_))
+        , path_(std::move(other.path_))
+        , path_cursor_(other.path_cursor_)
+        , path_bounds_(other.path_bounds_)
+        , has_current_point_(other.has_current_point_)
+        , pending_attributes_(std::move(other.pending_attributes_))
+        , pending_path_(std::move(other.pending_path_))
+        , pending_bounds_(std::move(other.pending_bounds_))
+        , style_classes_(std::move(other.style_classes_))
+        , deflate_stream_(std::move(other.deflate_stream_))
+        , compressed_(std::move(other.compressed_))
+        , state_(std::move(other.state_))
+        , saved_states_(std::move(other.saved_states_))
+        , open_clip_groups_(std::move(other.open_clip_groups_))
+        , next_id_(other.next_id_)
+        , glyph_ids_(std::move(other.glyph_ids_))
+        , finished_(other.finished_)
+    {
+    }
+
+    svg::~svg()
+    {
+        if ((sink_ != nullptr) && !finished_) complete_document();
+    }
+
+    void svg::set_line_width(const pixels width) { state_.line_width = width.value(); }
+
+    void svg::set_line_properties(const elem::line_properties& attributes)
+    {
+        state_.line_attributes.clear();
+        if (const auto* cap = to_svg_line_cap(attributes.cap))
+            fmt::format_to(std::back_inserter(state_.line_attributes), R"( stroke-linecap="{}")", cap);
+
+        // cairo's default miter limit is 10 whereas svg's is 4
+        if (const auto* join = to_svg_line_join(attributes.join))
+            fmt::format_to(std::back_inserter(state_.line_attributes), R"( stroke-linejoin="{}")", join);
+        else
+            state_.line_attributes += R"( stroke-miterlimit="10")";
+
+        state_.dashes = dash_sequence(attributes);
+        for (auto& dash : state_.dashes)
+            dash *= attributes.width.value();
+    }
+
+    void svg::set_color(const double r, const double g, const double b, const double a)
+    {
+        state_.paint = to_hex_color(r, g, b);
+        state_.opacity = a;
+    }
+
+    void svg::fill_background(const double r, const double g, const double b, const double a)
+    {
+        set_color(r, g, b, a);
+        write_pending_path();
+        fmt::format_to(std::back_inserter(out_), R"(<rect x="0" y="0" width="{}" height="{}")",
+                       to_coordinate(width_.value()), to_coordinate(height_.value()));
+        append_paint(out_, "fill", "fill-opacity");
+        out_ += "/>\n";
+        flush_output(output_block_size);
+    }
+
+    void svg::move_to(const pixel_pos pos)
+    {
+        append_point('M', to_device(pos));
+        has_current_point_ = true;
+    }
+
+    void svg::line_to(const pixel_pos pos)
+    {
+        append_point(has_current_point_ ? 'L' : 'M', to_device(pos));
+        has_current_point_ = true;
+    }
+
+    void svg::append_path(const std::span<const pixel_pos> positions)
+    {
+        if (positions.empty()) return;
+
+        append_point('M', to_device(positions.front()));
+        for (const auto& pos : positions.subspan(1))
+            append_point('L', to_device(pos));
+
+        has_current_point_ = true;
+    }
+
+    void svg::arc(const pixel_pos center, const pixels radius, const radians angle0, const radians angle1)
+    {
+        // like cairo_arc (and cairo_arc_negative if angle1 < angle0) the arc is approximated by cubic bezier
+        // curves of at most a quarter circle each, which stay exact under any transformation
+        const auto a0 = angle0.value();
+        const auto a1 = angle1.value();
+        const auto r = radius.value();
+        const auto point = [&](const double a) {
+            return pixel_pos{center.x + pixels(r * std::cos(a)), center.y + pixels(r * std::sin(a))};
+        };
+
+        line_to(point(a0));
+
+        const auto num_segments =
+            static_cast<int>(std::ceil(std::abs(a1 - a0) / (stdx::numbers::pi / 2.0) - 1e-9));
+        const auto step = (num_segments > 0) ? (a1 - a0) / num_segments : 0.0;
+        const auto k = 4.0 / 3.0 * std::tan(step / 4.0) * r;
+        for (auto i = 0; i < num_segments; ++i)
+        {
+            const auto t0 = a0 + i * step;
+            const auto t1 = t0 + step;
+            const auto p0 = point(t0);
+            const auto p3 = point(t1);
+            const auto p1 = pixel_pos{p0.x - pixels(k * std::sin(t0)), p0.y + pixels(k * std::cos(t0))};
+            const auto p2 = pixel_pos{p3.x + pixels(k * std::sin(t1)), p3.y - pixels(k * std::cos(t1))};
+            append_curve(to_device(p1), to_device(p2), to_device(p3));
+        }
+    }
+
+    void svg::stroke()
+    {
+        std::string attributes = R"( fill="none")";
+        append_paint(attributes, "stroke", "stroke-opacity");
+
+        const auto scale = device_scale();
+        fmt::format_to(std::back_inserter(attributes), R"( stroke-width="{}")",
+                       to_coordinate(state_.line_width * scale));
+        attributes += state_.line_attributes;
+        if (!state_.dashes.empty())
+        {
+            attributes += R"( stroke-dasharray=")";
+            for (const auto& dash : state_.dashes)
+            {
+                if (&dash != &state_.dashes.front()) attributes.push_back(' ');
+                attributes += to_coordinate(dash * scale);
+            }
+            attributes.push_back('"');
+        }
+
+        write_path(attributes, false);
+    }
+
+    void svg::fill()
+    {
+        std::string attributes;
+        append_paint(attributes, "fill", "fill-opacity");
+        write_path(attributes, true);
+    }
+
+    svg::fill_pattern_t svg::create_gradient(const pixels start, const pixels end)
+    {
+        return {.start = {start, pixels(0.0)}, .end = {end, pixels(0.0)}, .stops = {}};
+    }
+
+    void svg::add_gradient_stop(fill_pattern_t& gradient, const double r, const double g, const double b,
+                                const double a, const double offset)
+    {
+        fmt::format_to(std::back_inserter(gradient.stops), R"(<stop offset="{}" stop-color="{}")", to_number(offset),
+                       to_hex_color(r, g, b));
+        if (a < 1.0) fmt::format_to(std::back_inserter(gradient.stops), R"( stop-opacity="{}")", to_number(a));
+        gradient.stops += "/>";
+    }
+
+    void svg::set_fill_pattern(fill_pattern_t& pattern)
+    {
+        // like a cairo pattern the gradient is fixed to the transformation that is active when it is set
+        const auto id = next_id_++;
+        const auto start = to_device(pattern.start);
+        const auto end = to_device(pattern.end);
+        fmt::format_to(std::back_inserter(out_),
+                       R"(<defs><linearGradient id="p{}" gradientUnits="userSpaceOnUse" )"
+                       R"(x1="{}" y1="{}" x2="{}" y2="{}">)",
+                       id, to_coordinate(start.x.value()), to_coordinate(start.y.value()),
+                       to_coordinate(end.x.value()), to_coordinate(end.y.value()));
+        out_ += pattern.stops;
+        out_ += "</linearGradient></defs>\n";
+
+        state_.paint = fmt::format("url(#p{})", id);
+        state_.opacity = 1.0;
+    }
+
+    void svg::unset_fill_pattern() { set_color(0.0, 0.0, 0.0, 1.0); }
+
+    void svg::set_clip_rect(const pixel_pos origin, const pixel_pos extents)
+    {
+        const auto corners = std::array{to_device(origin), to_device({origin.x + extents.x, origin.y}),
+                                        to_device(origin + extents), to_device({origin.x, origin.y + extents.y})};
+
+        const auto id = next_id_++;
+        fmt::format_to(std::back_inserter(out_), R"(<clipPath id="c{}"><path d=")", id);
+        auto rect = clip_rect{.id = id, .min = corners[0], .max = corners[0]};
+        for (const auto& corner : corners)
+        {
+            out_.push_back((&corner == &corners.front()) ? 'M' : 'L');
+            out_ += to_coordinate(corner.x.value());
+            out_.push_back(' ');
+            out_ += to_coordinate(corner.y.value());
+            rect.min = {std::min(rect.min.x, corner.x), std::min(rect.min.y, corner.y)};
+            rect.max = {std::max(rect.max.x, corner.x), std::max(rect.max.y, corner.y)};
+        }
+        out_ += "Z\"/></clipPath>\n";
+
+        // setting a clip rect while another one is active clips to the intersection of both
+        if (!state_.clip_rects.empty())
+        {
+            const auto& outer = state_.clip_rects.back();
+            rect.min = {std::max(rect.min.x, outer.min.x), std::max(rect.min.y, outer.min.y)};
+            rect.max = {std::min(rect.max.x, outer.max.x), std::min(rect.max.y, outer.max.y)};
+        }
+
+        state_.clip_rects.push_back(rect);
+        update_clip_groups();
+    }
+
+    std::pair<pixel_pos, pixel_pos> svg::get_clip_rect() const
+    {
+        // like cairo_clip_extents this returns the bounding box of the clip area in user coordinates
+        auto min = pixel_pos{};
+        auto max = pixel_pos{width_, height_};
+        if (!state_.clip_rects.empty())
+        {
+            min = state_.clip_rects.back().min;
+            max = state_.clip_rects.back().max;
+        }
+
+        const auto& m = state_.transformation;
+        const auto det = m.xx * m.yy - m.xy * m.yx;
+        const auto to_user = [&](const double x, const double y) {
+            const auto dx = x - m.x0;
+            const auto dy = y - m.y0;
+            return pixel_pos{pixels((m.yy * dx - m.xy * dy) / det), pixels((m.xx * dy - m.yx * dx) / det)};
+        };
+
+        const auto corners = std::array{to_user(min.x.value(), min.y.value()), to_user(max.x.value(), min.y.value()),
+                                        to_user(max.x.value(), max.y.value()), to_user(min.x.value(), max.y.value())};
+        auto user_min = corners[0];
+        auto user_max = corners[0];
+        for (const auto& corner : corners)
+        {
+            user_min = {std::min(user_min.x, corner.x), std::min(user_min.y, corner.y)};
+            user_max = {std::max(user_max.x, corner.x), std::max(user_max.y, corner.y)};
+        }
+
+        return {user_min, user_max};
+    }
+
+    void svg::unset_clip_rect()
+    {
+        state_.clip_rects.clear();
+        update_clip_groups();
+    }
+
+    void svg::set_font(FT_FaceRec_* ft_face, const pixels size)
+    {
+        state_.font_face = ft_face;
+        state_.font_size = size.value();
+    }
+
+    void svg::draw_glyphs(const std::vector<fnt::shaped_glyph>& glyphs)
+    {
+        auto* face = state_.font_face;
+        if ((face == nullptr) || (face->units_per_EM == 0) || glyphs.empty()) return;
+
+        write_pending_path();
+        auto has_new_glyphs = false;
+        for (const auto& glyph : glyphs)
+        {
+            if (!glyph_ids_.try_emplace(std::pair(face, glyph.index), next_id_).second) continue;
+
+            if (!has_new_glyphs) out_ += "<defs>";
+            has_new_glyphs = true;
+            fmt::format_to(std::back_inserter(out_), R"(<path id="g{}" d=")", next_id_++);
+            append_glyph_outline(out_, face, glyph.index);
+            out_ += "\"/>";
+        }
+        if (has_new_glyphs) out_ += "</defs>\n";
+
+        std::string attributes;
+        append_paint(attributes, "fill", "fill-opacity");
+        const auto style = style_attributes(attributes);
+        out_ += "<g";
+        out_ += style;
+        out_ += ">\n";
+
+        // glyph outlines are in font units with y pointing upwards whereas in the user space of text y points down
+        const auto scale = state_.font_size / static_cast<double>(face->units_per_EM);
+        const auto& m = state_.transformation;
+        for (const auto& glyph : glyphs)
+        {
+            const auto origin = to_device(glyph.pos);
+            fmt::format_to(std::back_inserter(out_),
+                           "<use xlink:href=\"#g{}\" transform=\"matrix({} {} {} {} {} {})\"/>\n",
+                           glyph_ids_.at({face, glyph.index}), to_factor(m.xx * scale), to_factor(m.yx * scale),
+                           to_factor(-m.xy * scale), to_factor(-m.yy * scale), to_coordinate(origin.x.value()),
+                           to_coordinate(origin.y.value()));
+        }
+
+        out_ += "</g>\n";
+        flush_output(output_block_size);
+    }
+
+    void svg::push_transformation(const pixel_pos translation, const radians rotation_angle, const vec2<double> scale)
+    {
+        saved_states_.push_back(state_);
+
+        const auto c = std::cos(rotation_angle.value());
+        const auto s = std::sin(rotation_angle.value());
+        auto& m = state_.transformation;
+        const auto origin = to_device(translation);
+
+        // m * translation * rotation * scale
+        m = {.xx = (m.xx * c + m.xy * s) * scale.x,
+             .yx = (m.yx * c + m.yy * s) * scale.x,
+             .xy = (m.xy * c - m.xx * s) * scale.y,
+             .yy = (m.yy * c - m.yx * s) * scale.y,
+             .x0 = origin.x.value(),
+             .y0 = origin.y.value()};
+    }
+
+    void svg::pop_transformation()
+    {
+        // like cairo_restore this also restores the color, line properties, font and clip area
+        state_ = std::move(saved_states_.back());
+        saved_states_.pop_back();
+        update_clip_groups();
+    }
+
+    void svg::finish()
+    {
+        if (!finished_) complete_document();
+        sink_->flush();
+    }
+
+    pixel_pos svg::to_device(const pixel_pos pos) const
+    {
+        const auto& m = state_.transformation;
+        const auto x = pos.x.value();
+        const auto y = pos.y.value();
+        return {pixels(m.xx * x + m.xy * y + m.x0), pixels(m.yx * x + m.yy * y + m.y0)};
+    }
+
+    double svg::device_scale() const
+    {
+        const auto& m = state_.transformation;
+        return std::sqrt(std::abs(m.xx * m.yy - m.xy * m.yx));
+    }
+
+    std::string svg::to_coordinate(const double value) const
+    {
+        std::string result;
+        append_fixed(result, std::llround(value * coordinate_scale_));
+        return result;
+    }
+
+    void svg::append_fixed(std::string& out, const long long value) const
+    {
+        // the value is in units of the coordinate precision, so rounding can't produce "-0"
+        const auto unit = static_cast<unsigned long long>(powers_of_ten[size_t(options_.precision)]);
+        const auto magnitude = (value < 0) ? 0ull - static_cast<unsigned long long>(value)
+                                           : static_cast<unsigned long long>(value);
+        const auto integral = magnitude / unit;
+        auto fraction = magnitude % unit;
+
+        if (value < 0) out.push_back('-');
+        if ((integral != 0) || (fraction == 0) || !options_.relative_path_commands)
+            fmt::format_to(std::back_inserter(out), "{}", integral);
+
+        if (fraction != 0)
+        {
+            auto num_digits = options_.precision;
+            for (; fraction % 10 == 0; fraction /= 10)
+                --num_digits;
+
+            fmt::format_to(std::back_inserter(out), ".{:0{}}", fraction, num_digits);
+        }
+    }
+
+    void svg::append_command(std::string& out, path_cursor& cursor, const char command,
+                             const std::span<const long long> numbers) const
+    {
+        // in compact path data a repeated command can omit its letter and numbers only need a separator if the
+        // next one would otherwise continue the previous one
+        const auto compact = options_.relative_path_commands;
+        if (!compact || (command != cursor.command))
+        {
+            out.push_back(command);
+            cursor.after_number = false;
+        }
+
+        std::string number;
+        for (const auto value : numbers)
+        {
+            number.clear();
+            append_fixed(number, value);
+            const auto continues_number =
+                (number.front() != '-') && ((number.front() != '.') || !cursor.after_decimal_point);
+            if (cursor.after_number && (!compact || continues_number)) out.push_back(' ');
+
+            out += number;
+            cursor.after_number = true;
+            cursor.after_decimal_point = number.find('.') != std::string::npos;
+        }
+
+        // the coordinates after a moveto are implicit lineto commands
+        cursor.command = (command == 'M') ? 'L' : (command == 'm') ? 'l' : command;
+    }
+
+    void svg::append_path_command(const char command, const std::span<const pixel_pos> device_points)
+    {
+        std::array<long long, 6> absolute{};
+        std::array<long long, 6> relative{};
+        auto& cursor = path_cursor_;
+        for (size_t i = 0; i < device_points.size(); ++i)
+        {
+            const auto& pos = device_points[i];
+            if (path_.empty() && (i == 0)) path_bounds_ = {.min = pos, .max = pos};
+            path_bounds_ = {.min = {std::min(path_bounds_.min.x, pos.x), std::min(path_bounds_.min.y, pos.y)},
+                            .max = {std::max(path_bounds_.max.x, pos.x), std::max(path_bounds_.max.y, pos.y)}};
+
+            absolute[2 * i] = std::llround(pos.x.value() * coordinate_scale_);
+            absolute[2 * i + 1] = std::llround(pos.y.value() * coordinate_scale_);
+            relative[2 * i] = absolute[2 * i] - cursor.x;
+            relative[2 * i + 1] = absolute[2 * i + 1] - cursor.y;
+        }
+
+        // every path starts with an absolute command, so that merged paths don't depend on each other
+        const auto num_values = 2 * device_points.size();
+        if (!options_.relative_path_commands || path_.empty())
+            append_command(path_, cursor, command, std::span(absolute).first(num_values));
+        else
+        {
+            // horizontal and vertical lines only need one coordinate
+            auto letter = command;
+            auto first = size_t(0);
+            auto count = num_values;
+            if ((command == 'L') && (relative[1] == 0))
+                std::tie(letter, count) = std::pair('H', size_t(1));
+            else if ((command == 'L') && (relative[0] == 0))
+                std::tie(letter, first, count) = std::tuple('V', size_t(1), size_t(1));
+
+            // all points of a relative command are relative to the current point, whichever form is shorter wins
+            auto relative_cursor = cursor;
+            relative_command_.clear();
+            append_command(relative_command_, relative_cursor, static_cast<char>(letter - 'A' + 'a'),
+                           std::span(relative).subspan(first, count));
+
+            const auto size = path_.size();
+            append_command(path_, cursor, letter, std::span(absolute).subspan(first, count));
+            if (relative_command_.size() < path_.size() - size)
+            {
+                path_.resize(size);
+                path_ += relative_command_;
+                cursor = relative_cursor;
+            }
+        }
+
+        cursor.x = absolute[num_values - 2];
+        cursor.y = absolute[num_values - 1];
+    }
+
+    void svg::append_point(const char command, const pixel_pos device_pos)
+    {
+        append_path_command(command, std::span(&device_pos, 1));
+    }
+
+    void svg::append_curve(const pixel_pos control0, const pixel_pos control1, const pixel_pos end)
+    {
+        const auto points = std::array{control0, control1, end};
+        append_path_command('C', points);
+    }
+
+    void svg::write_path(const std::string& attributes, const bool is_fill)
+    {
+        // like cairo_fill and cairo_stroke this consumes the current path
+        if (!path_.empty())
+        {
+            if (!can_merge_path(attributes, is_fill)) write_pending_path();
+            if (pending_path_.empty()) pending_attributes_ = attributes;
+
+            pending_path_ += path_;
+            pending_bounds_.push_back(path_bounds_);
+            if (!options_.merge_paths) write_pending_path();
+        }
+
+        path_.clear();
+        path_cursor_ = {};
+        has_current_point_ = false;
+        flush_output(output_block_size);
+    }
+
+    bool svg::can_merge_path(const std::string& attributes, const bool is_fill) const
+    {
+        if (!options_.merge_paths || pending_path_.empty() || (attributes != pending_attributes_)) return false;
+        if (pending_bounds_.size() >= max_merged_paths) return false;
+
+        // overlapping strokes are only the same as a single one if they are opaque, whereas overlapping fills could
+        // cancel each other out depending on their orientation
+        if (!is_fill) return (state_.opacity >= 1.0) && state_.paint.starts_with('#');
+
+        const auto overlaps = [&](const bounding_box& bounds) {
+            return (bounds.min.x < path_bounds_.max.x) && (path_bounds_.min.x < bounds.max.x) &&
+                   (bounds.min.y < path_bounds_.max.y) && (path_bounds_.min.y < bounds.max.y);
+        };
+        return std::none_of(pending_bounds_.begin(), pending_bounds_.end(), overlaps);
+    }
+
+    void svg::write_pending_path()
+    {
+        if (pending_path_.empty()) return;
+
+        const auto style = style_attributes(pending_attributes_);
+        out_ += "<path";
+        out_ += style;
+        out_ += R"( d=")";
+        out_ += pending_path_;
+        out_ += "\"/>\n";
+
+        pending_path_.clear();
+        pending_bounds_.clear();
+    }
+
+    void svg::append_paint(std::string& out, const char* attribute, const char* opacity_attribute) const
+    {
+        fmt::format_to(std::back_inserter(out), R"( {}="{}")", attribute, state_.paint);
+        if (state_.opacity < 1.0)
+            fmt::format_to(std::back_inserter(out), R"( {}="{}")", opacity_attribute, to_number(state_.opacity));
+    }
+
+    std::string svg::style_attributes(const std::string& attributes)
+    {
+        if (!options_.shared_styles) return attributes;
+
+        // the style element of a class is written the first time it is used, css rules apply to the whole document
+        const auto [it, inserted] = style_classes_.try_emplace(attributes, style_classes_.size());
+        if (inserted)
+            fmt::format_to(std::back_inserter(out_), "<style>.s{}{{{}}}</style>\n", it->second, to_css(attributes));
+
+        return fmt::format(R"( class="s{}")", it->second);
+    }
+
+    void svg::update_clip_groups()
+    {
+        // every clip rect is a group that references its clip path, so reactivating a clip rect after it was
+        // unset (or restored by pop_transformation) just opens a new group for the existing clip path
+        const auto& clip_rects = state_.clip_rects;
+        size_t num_common = 0;
+        while ((num_common < open_clip_groups_.size()) && (num_common < clip_rects.size()) &&
+               (open_clip_groups_[num_common] == clip_rects[num_common].id))
+            ++num_common;
+
+        if ((num_common < open_clip_groups_.size()) || (num_common < clip_rects.size())) write_pending_path();
+        for (; open_clip_groups_.size() > num_common; open_clip_groups_.pop_back())
+            out_ += "</g>\n";
+
+        for (auto i = num_common; i < clip_rects.size(); ++i)
+        {
+            fmt::format_to(std::back_inserter(out_), "<g clip-path=\"url(#c{})\">\n", clip_rects[i].id);
+            open_clip_groups_.push_back(clip_rects[i].id);
+        }
+    }
+
+    void svg::complete_document()
+    {
+        write_pending_path();
+        state_.clip_rects.clear();
+        update_clip_groups();
+        out_ += "</svg>\n";
+        if (deflate_stream_)
+        {
+            deflate_output(true);
+            out_.clear();
+        }
+        else
+            flush_output(0);
+
+        finished_ = true;
+    }
+
+    void svg::flush_output(const size_t min_size)
+    {
+        if (out_.size() < min_size) return;
+
+        if (deflate_stream_)
+            deflate_output(false);
+        else
+            sink_->write(out_.data(), out_.size());
+
+        out_.clear();
+    }
+
+    void svg::deflate_output(const bool finish)
+    {
+        auto& stream = *deflate_stream_;
+        stream.next_in = reinterpret_cast<Bytef*>(out_.data());
+        stream.avail_in = static_cast<uInt>(out_.size());
+        do
+        {
+            stream.next_out = compressed_.data();
+            stream.avail_out = static_cast<uInt>(compressed_.size());
+            deflate(&stream, finish ? Z_FINISH : Z_NO_FLUSH);
+            sink_->write(compressed_.data(), compressed_.size() - stream.avail_out);
+        } while (stream.avail_out == 0);
+    }
+}
@@ -0,0 +1,81 @@
+#include <cdv/fnt/font_context.hpp>
+
+#include <fnt/mfl_font_face.hpp>
+
+#include <fmt/format.h>
+#include <fontconfig/fontconfig.h>
+
+#include <stdexcept>
+#include <string>
+
+namespace cdv::fnt
+{
+    namespace
+    {
+        constexpr auto font_directory = CDV_DATA_DIR "/fonts/ttf";
+
+        FcConfig* create_system_fonts_config()
+        {
+            auto* config = FcInitLoadConfigAndFonts();
+            if (!config) throw std::runtime_error("Failed to initialize fontconfig");
+
+            if (!FcConfigAppFontAddDir(config, reinterpret_cast<const FcChar8*>(font_directory)))
+            {
+                FcConfigDestroy(config);
+                throw std::runtime_error("Failed to add cdv font directory to fontconfig");
+            }
+
+            return config;
+        }
+
+        std::string bundled_fonts_config(const std::filesystem::path& cache_directory)
+        {
+            return fmt::format(R"(<?xml version="1.0"?>
+<!DOCTYPE fontconfig SYSTEM "fonts.dtd">
+<fontconfig>
+  <dir>{}</dir>
+  <cachedir>{}</cachedir>
+  <alias><family>sans-serif</family><prefer><family>DejaVu Sans</family></prefer></alias>
+  <alias><family>serif</family><prefer><family>DejaVu Serif</family></prefer></alias>
+  <alias><family>monospace</family><prefer><family>DejaVu Sans Mono</family></prefer></alias>
+</fontconfig>
+)",
+                               font_directory, cache_directory.string());
+        }
+
+        FcConfig* create_bundled_fonts_config(const std::filesystem::path& cache_directory)
+        {
+            auto* config = FcConfigCreate();
+            if (!config) throw std::runtime_error("Failed to initialize fontconfig");
+
+            const auto xml = bundled_fonts_config(cache_directory.empty()
+                                                      ? std::filesystem::path(CDV_DATA_DIR "/fonts/cache")
+                                                      : cache_directory);
+            if (!FcConfigParseAndLoadFromMemory(config, reinterpret_cast<const FcChar8*>(xml.c_str()), FcTrue)
+                || !FcConfigBuildFonts(config))
+            {
+                FcConfigDestroy(config);
+                throw std::runtime_error("Failed to set up fontconfig for the cdv fonts");
+            }
+
+            return config;
+        }
+    }
+
+    font_context::font_context(const font_context_options& options)
+        : fc_config_(options.bundled_fonts_only ? create_bundled_fonts_config(options.font_cache_directory)
+                                                : create_system_fonts_config(),
+                     FcConfigDestroy)
+        , cache_(options.shaped_text_cache_capacity)
+        , math_faces_(std::make_unique<mfl_face_cache>())
+    {
+    }
+
+    font_context::~font_context() = default;
+
+    std::shared_ptr<font_context> font_context::shared()
+    {
+        static const auto context = std::make_shared<font_context>();
+        return context;
+    }
+}
@@ -1,13 +1,19 @@
 #include <cdv/fnt/freetype.hpp>
 
+#include <cdv/stdx/hash.hpp>
 #include <fnt/freetype_error.hpp>
+#include <fnt/mapped_file.hpp>
 
 #include <ft2build.h>
 #include FT_FREETYPE_H
-#include <range/v3/algorithm/find_if.hpp>
+#include FT_MODULE_H
+#include <harfbuzz/hb-ft.h>
 
 #include <array>
+#include <map>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 
 namespace cdv::fnt
 {
@@ -21,62 +27,179 @@ namespace cdv::fnt
             return result;
         }
 
-        FT_Face create_freetype_face(freetype::library_t& ft_lib, const std::filesystem::path& font_path,
-                                     const int index)
+        FT_Face create_freetype_face(freetype::library_t& ft_lib, const mapped_file& file,
+                                     const std::filesystem::path& font_path, const int index)
         {
             FT_Face result = nullptr;
-            if (const auto err = FT_New_Face(&ft_lib, font_path.string().c_str(), FT_Long(index), &result); err != 0)
+            if (const auto err = FT_New_Memory_Face(&ft_lib, file.data(), FT_Long(file.size()), FT_Long(index), &result);
+                err != 0)
                 throw std::runtime_error("Failed to load font '" + font_path.string() + "': " + ft_error_string(err));
 
             return result;
         }
 
-        FT_Face create_mfl_face(freetype::library_t& ft_lib, const std::string& file_name)
+        // Every face carries the size it was last set to, the HarfBuzz font that is used to shape text
+        // with it and the glyph heights that have been measured so far for each size. The state is attached
+        // to the face through its 'generic' client data field, so it lives exactly as long as the face does.
+        // Only the heights of glyphs that were actually used are stored, fallback faces can have tens of
+        // thousands of glyphs of which a label needs a handful
+        struct face_state
         {
-            const auto data_dir = std::filesystem::path(CDV_DATA_DIR);
-            return create_freetype_face(ft_lib, data_dir / "fonts" / "ttf" / file_name, 0);
+            using glyph_heights = std::unordered_map<FT_UInt, FT_Pos>;
+
+            std::shared_ptr<const mapped_file> file;
+            std::unique_ptr<hb_font_t, decltype(&hb_font_destroy)> hb_font{nullptr, hb_font_destroy};
+            points size{0};
+            dots_per_inch dpi{0};
+            FT_Fixed x_scale = 0;
+            FT_Fixed y_scale = 0;
+            std::map<std::pair<double, double>, glyph_heights> heights_by_size;
+            glyph_heights* current_heights = nullptr;
+        };
+
+        void destroy_face_state(void* object)
+        {
+            auto* ft_face = static_cast<FT_Face>(object);
+            delete static_cast<face_state*>(ft_face->generic.data);
+            ft_face->generic.data = nullptr;
+        }
+
+        face_state& get_face_state(FT_Face ft_face)
+        {
+            if (ft_face->generic.data == nullptr)
+            {
+                ft_face->generic.data = new face_state();
+                ft_face->generic.finalizer = destroy_face_state;
+            }
+
+            return *static_cast<face_state*>(ft_face->generic.data);
+        }
+
+        // The reference counts of faces and libraries aren't atomic, and shared faces are released on any thread.
+        // The mutex is never destroyed, since cairo releases its fonts at exit.
+        std::mutex& reference_mutex()
+        {
+            static auto& mutex = *new std::mutex();
+            return mutex;
+        }
+
+        size_t mfl_face_slot(const mfl::font_family family)
+        {
+            if (family == mfl::font_family::italic) return 1;
+
+            if (family == mfl::font_family::bold) return 2;
+
+            if (family == mfl::font_family::mono) return 3;
+
+            return 0;
+        }
+
+        std::filesystem::path mfl_font_path(const size_t slot)
+        {
+            constexpr auto file_names =
+                std::array{"Stix2Math.otf", "Stix2Text-Italic.otf", "Stix2Text-Bold.otf", "DejaVuSansMono.ttf"};
+            return std::filesystem::path(CDV_DATA_DIR) / "fonts" / "ttf" / file_names[slot];
         }
     }
 
-    freetype::freetype()
-        : library_(create_freetype_library(), FT_Done_FreeType)
-        , mfl_normal_face_(create_mfl_face(*library_, "Stix2Math.otf"), FT_Done_Face)
-        , mfl_italic_face_(create_mfl_face(*library_, "Stix2Text-Italic.otf"), FT_Done_Face)
-        , mfl_bold_face_(create_mfl_face(*library_, "Stix2Text-Bold.otf"), FT_Done_Face)
-        , mfl_mono_face_(create_mfl_face(*library_, "DejaVuSansMono.ttf"), FT_Done_Face)
+    size_t freetype::face_key_hash::operator()(const face_key& key) const
     {
+        return stdx::hash_values(key.first, key.second);
     }
 
-    freetype::face_t& freetype::face(const std::filesystem::path& font_path, const int index) const
+    freetype::freetype() : library_(create_freetype_library(), FT_Done_FreeType) {}
+
+    freetype::~freetype()
     {
-        const auto path_name = font_path.string();
-        auto it = ranges::find_if(face_cache_, [&](const face_cache_entry& f) { return f.first == path_name; });
-        if (it == face_cache_.end())
-        {
-            const auto& entry = face_cache_.emplace_back(
-                path_name, face_ptr(create_freetype_face(*library_, font_path, index), FT_Done_Face));
-            return *entry.second;
-        }
+        const auto lock = std::lock_guard(reference_mutex());
+        face_cache_.clear();
+        library_.reset();
+    }
 
-        return *it->second;
+    freetype::face_t& freetype::face(const std::filesystem::path& font_path, const int index) const
+    {
+        auto key = face_key(font_path.string(), index);
+        if (const auto it = face_cache_.find(key); it != face_cache_.end()) return *it->second.face;
+
+        auto file = mapped_file::open(font_path);
+        auto face = face_ptr(create_freetype_face(*library_, *file, font_path, index), FT_Done_Face);
+        get_face_state(face.get()).file = file;
+        const auto& entry = face_cache_.emplace(std::move(key), face_cache_entry{std::move(file), std::move(face)});
+        return *entry.first->second.face;
     }
 
     freetype::face_t& freetype::face(const mfl::font_family family) const
     {
-        if (family == mfl::font_family::italic) return *mfl_italic_face_;
-
-        if (family == mfl::font_family::bold) return *mfl_bold_face_;
-
-        if (family == mfl::font_family::mono) return *mfl_mono_face_;
+        const auto slot = mfl_face_slot(family);
+        if (!mfl_faces_[slot]) mfl_faces_[slot] = &face(mfl_font_path(slot), 0);
 
-        return *mfl_normal_face_;
+        return *mfl_faces_[slot];
     }
 
     void freetype::set_size(FT_Face ft_face, const points size, const dots_per_inch dpi)
     {
+        // the scales are compared as well because other users of the face (e.g. cairo) may have
+        // changed the size of the face since we last set it
+        auto& state = get_face_state(ft_face);
+        const auto& metrics = ft_face->size->metrics;
+        if ((state.size == size) && (state.dpi == dpi) && (state.x_scale == metrics.x_scale)
+            && (state.y_scale == metrics.y_scale))
+            return;
+
         const auto dpi_value = static_cast<FT_UInt>(dpi.value());
         const auto size_value = static_cast<FT_F26Dot6>(size.value() * 64);
         if (const auto err = FT_Set_Char_Size(ft_face, 0, size_value, dpi_value, dpi_value); err != 0)
             throw std::invalid_argument(ft_error_string(err));
+
+        state.size = size;
+        state.dpi = dpi;
+        state.x_scale = ft_face->size->metrics.x_scale;
+        state.y_scale = ft_face->size->metrics.y_scale;
+        if (state.hb_font) hb_ft_font_changed(state.hb_font.get());
+
+        state.current_heights = &state.heights_by_size[{size.value(), dpi.value()}];
+    }
+
+    hb_font_t* freetype::hb_font(FT_Face ft_face)
+    {
+        auto& state = get_face_state(ft_face);
+        if (!state.hb_font) state.hb_font.reset(hb_ft_font_create(ft_face, nullptr));
+
+        return state.hb_font.get();
+    }
+
+    FT_Pos freetype::glyph_height(FT_Face ft_face, const FT_UInt glyph_index)
+    {
+        const auto load_height = [&] {
+            FT_Load_Glyph(ft_face, glyph_index, FT_LOAD_DEFAULT);
+            return ft_face->glyph->metrics.height;
+        };
+
+        auto* heights = get_face_state(ft_face).current_heights;
+        if (heights == nullptr) return load_height();
+
+        if (const auto it = heights->find(glyph_index); it != heights->end()) return it->second;
+
+        return heights->emplace(glyph_index, load_height()).first->second;
+    }
+
+    std::shared_ptr<freetype::face_t> freetype::share_face(FT_Face ft_face)
+    {
+        const auto lock = std::lock_guard(reference_mutex());
+        auto* library = ft_face->glyph->library;
+        if (const auto err = FT_Reference_Library(library); err != 0) throw std::runtime_error(ft_error_string(err));
+
+        if (const auto err = FT_Reference_Face(ft_face); err != 0)
+        {
+            FT_Done_Library(library);
+            throw std::runtime_error(ft_error_string(err));
+        }
+
+        // the file is released after the face, FreeType may still read from it while the face is being destroyed
+        return std::shared_ptr<face_t>(ft_face, [library, file = get_face_state(ft_face).file](FT_Face face) {
+            const auto lock = std::lock_guard(reference_mutex());
+            FT_Done_Face(face);
+            FT_Done_Library(library);
+        });
     }
 }
@@ -0,0 +1,105 @@
+#include <fnt/mapped_file.hpp>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+namespace cdv::fnt
+{
+    namespace
+    {
+        [[noreturn]] void throw_mapping_error(const std::filesystem::path& path, const std::string& reason)
+        {
+            throw std::runtime_error("Failed to map font file '" + path.string() + "': " + reason);
+        }
+    }
+
+#ifdef _WIN32
+    mapped_file::mapped_file(const std::filesystem::path& path)
+    {
+        file_ = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) throw_mapping_error(path, "could not open file");
+
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file_, &file_size) || (file_size.QuadPart == 0))
+        {
+            CloseHandle(file_);
+            throw_mapping_error(path, "could not determine file size");
+        }
+
+        mapping_ = CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping_ == nullptr)
+        {
+            CloseHandle(file_);
+            throw_mapping_error(path, "could not create file mapping");
+        }
+
+        data_ = static_cast<const unsigned char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+        if (data_ == nullptr)
+        {
+            CloseHandle(mapping_);
+            CloseHandle(file_);
+            throw_mapping_error(path, "could not map view of file");
+        }
+
+        size_ = static_cast<size_t>(file_size.QuadPart);
+    }
+
+    mapped_file::~mapped_file()
+    {
+        UnmapViewOfFile(data_);
+        CloseHandle(mapping_);
+        CloseHandle(file_);
+    }
+#else
+    mapped_file::mapped_file(const std::filesystem::path& path)
+    {
+        const auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) throw_mapping_error(path, "could not open file");
+
+        struct stat file_status = {};
+        if ((fstat(fd, &file_status) != 0) || (file_status.st_size == 0))
+        {
+            ::close(fd);
+            throw_mapping_error(path, "could not determine file size");
+        }
+
+        const auto size = static_cast<size_t>(file_status.st_size);
+        auto* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);  // the mapping keeps its own reference to the file
+        if (data == MAP_FAILED) throw_mapping_error(path, "mmap failed");
+
+        data_ = static_cast<const unsigned char*>(data);
+        size_ = size;
+    }
+
+    mapped_file::~mapped_file() { munmap(const_cast<unsigned char*>(data_), size_); }
+#endif
+
+    std::shared_ptr<const mapped_file> mapped_file::open(const std::filesystem::path& path)
+    {
+        static std::mutex mutex;
+        static std::unordered_map<std::string, std::weak_ptr<const mapped_file>> files;
+
+        const auto lock = std::lock_guard(mutex);
+        auto& file = files[path.string()];
+        if (auto result = file.lock()) return result;
+
+        auto result = std::make_shared<const mapped_file>(path);
+        file = result;
+        return result;
+    }
+}
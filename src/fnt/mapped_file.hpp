@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+
+namespace cdv::fnt
+{
+    // A read only memory mapping of a complete file. Font files are mapped at most once per process - open()
+    // hands out the existing mapping for as long as any face (of any font context) still uses it.
+    class mapped_file
+    {
+    public:
+        explicit mapped_file(const std::filesystem::path& path);
+        ~mapped_file();
+
+        mapped_file(const mapped_file&) = delete;
+        mapped_file& operator=(const mapped_file&) = delete;
+
+        [[nodiscard]] static std::shared_ptr<const mapped_file> open(const std::filesystem::path& path);
+
+        [[nodiscard]] const unsigned char* data() const { return data_; }
+        [[nodiscard]] size_t size() const { return size_; }
+
+    private:
+        const unsigned char* data_ = nullptr;
+        size_t size_ = 0;
+#ifdef _WIN32
+        void* file_ = nullptr;
+        void* mapping_ = nullptr;
+#endif
+    };
+}
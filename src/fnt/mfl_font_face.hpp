@@ -2,6 +2,7 @@
 
 #include <cdv/fnt/freetype.hpp>
 
+#include <harfbuzz/hb.h>
 #include <mfl/abstract_font_face.hpp>
 #include <mfl/font_family.hpp>
 #include <mfl/units.hpp>
@@ -9,12 +10,39 @@
 #include FT_FREETYPE_H
 #include <ft2build.h>
 
+#include <map>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 namespace cdv::fnt
 {
+    // The math tables of a face only change with its size, so everything mfl asks for during a layout is
+    // remembered per face and size. This makes repeated layouts with the same fonts a series of lookups.
+    class mfl_face_cache
+    {
+    public:
+        struct sized_face_data
+        {
+            std::optional<mfl::math_constants> constants;
+            std::unordered_map<size_t, mfl::math_glyph_info> glyph_infos;
+            std::unordered_map<mfl::code_point, std::vector<mfl::size_variant>> horizontal_size_variants;
+            std::unordered_map<mfl::code_point, std::vector<mfl::size_variant>> vertical_size_variants;
+        };
+
+        [[nodiscard]] sized_face_data& data(const FT_Face ft_face, const mfl::points size);
+
+        void clear() { data_.clear(); }
+
+    private:
+        std::map<std::pair<FT_Face, double>, sized_face_data> data_;
+    };
+
     class mfl_font_face : public mfl::abstract_font_face
     {
     public:
-        mfl_font_face(const mfl::font_family family, const freetype& ft);
+        mfl_font_face(const mfl::font_family family, const freetype& ft, mfl_face_cache& cache);
 
         [[nodiscard]] mfl::math_constants constants() const override;
         [[nodiscard]] mfl::math_glyph_info glyph_info(const size_t glyph_index) const override;
@@ -24,6 +52,11 @@ namespace cdv::fnt
         void set_size(const mfl::points size) override;
 
     private:
+        [[nodiscard]] std::vector<mfl::size_variant> size_variants(const mfl::code_point char_code,
+                                                                   const hb_direction_t dir) const;
+
         FT_Face ft_face_ = nullptr;
+        mfl_face_cache* cache_ = nullptr;
+        mfl_face_cache::sized_face_data* data_ = nullptr;
     };
 }
\ No newline at end of file
@@ -0,0 +1,154 @@
+#include <cdv/fnt/shaping_cache.hpp>
+
+#include <cdv/stdx/hash.hpp>
+
+namespace cdv::fnt
+{
+    size_t shaping_cache::face_size_key_hash::operator()(const face_size_key& key) const
+    {
+        return stdx::hash_values(key.face, key.size, key.dpi);
+    }
+
+    size_t shaping_cache::face_selection_key_hash::operator()(const face_selection_key& key) const
+    {
+        const auto& p = key.properties;
+        return stdx::hash_values(p.family, p.slant, p.weight, p.stretch, key.size);
+    }
+
+    size_t shaping_cache::text_key_hash::operator()(const text_key& key) const
+    {
+        auto result = face_size_key_hash()(key.face_size);
+        stdx::hash_combine(result, key.text);
+        stdx::hash_combine(result, key.is_formula);
+        return result;
+    }
+
+    shaping_cache::shaping_cache(const size_t capacity) : capacity_(capacity) {}
+
+    freetype::face_t* shaping_cache::find_face(const font_properties& properties, const points size)
+    {
+        const auto it = faces_.find(face_selection_key{properties, size.value()});
+        if (it == faces_.end())
+        {
+            ++face_statistics_.misses;
+            return nullptr;
+        }
+
+        ++face_statistics_.hits;
+        return it->second;
+    }
+
+    void shaping_cache::insert_face(const font_properties& properties, const points size, freetype::face_t* face)
+    {
+        faces_.insert_or_assign(face_selection_key{properties, size.value()}, face);
+    }
+
+    const shaped_text* shaping_cache::find_text(const std::string_view text, const freetype::face_t* face,
+                                                const points size, const dots_per_inch dpi)
+    {
+        return find(text_key{text, {face, size.value(), dpi.value()}, false}, text_statistics_);
+    }
+
+    void shaping_cache::insert_text(const std::string_view text, const freetype::face_t* face, const points size,
+                                    const dots_per_inch dpi, const shaped_text& shaped)
+    {
+        insert(text_key{text, {face, size.value(), dpi.value()}, false}, shaped);
+    }
+
+    const shaped_text* shaping_cache::find_formula(const std::string_view formula, const points size,
+                                                   const dots_per_inch dpi)
+    {
+        return find(text_key{formula, {nullptr, size.value(), dpi.value()}, true}, formula_statistics_);
+    }
+
+    void shaping_cache::insert_formula(const std::string_view formula, const points size, const dots_per_inch dpi,
+                                       const shaped_text& shaped)
+    {
+        insert(text_key{formula, {nullptr, size.value(), dpi.value()}, true}, shaped);
+    }
+
+    std::optional<pixels> shaping_cache::find_vertical_extent(const freetype::face_t* face, const points size,
+                                                              const dots_per_inch dpi)
+    {
+        const auto it = vertical_extents_.find(face_size_key{face, size.value(), dpi.value()});
+        if (it == vertical_extents_.end())
+        {
+            ++vertical_extent_statistics_.misses;
+            return std::nullopt;
+        }
+
+        ++vertical_extent_statistics_.hits;
+        return it->second;
+    }
+
+    void shaping_cache::insert_vertical_extent(const freetype::face_t* face, const points size,
+                                               const dots_per_inch dpi, const pixels extent)
+    {
+        vertical_extents_.insert_or_assign(face_size_key{face, size.value(), dpi.value()}, extent);
+    }
+
+    const numeric_glyph_table* shaping_cache::find_numeric_glyphs(const freetype::face_t* face, const points size,
+                                                                  const dots_per_inch dpi) const
+    {
+        const auto it = numeric_glyphs_.find(face_size_key{face, size.value(), dpi.value()});
+        return (it == numeric_glyphs_.end()) ? nullptr : &it->second;
+    }
+
+    const numeric_glyph_table& shaping_cache::insert_numeric_glyphs(const freetype::face_t* face, const points size,
+                                                                    const dots_per_inch dpi,
+                                                                    const numeric_glyph_table& table)
+    {
+        return numeric_glyphs_.insert_or_assign(face_size_key{face, size.value(), dpi.value()}, table).first->second;
+    }
+
+    const shaped_text* shaping_cache::find(const text_key& key, cache_statistics& statistics)
+    {
+        const auto it = index_.find(key);
+        if (it == index_.end())
+        {
+            ++statistics.misses;
+            return nullptr;
+        }
+
+        ++statistics.hits;
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return &it->second->shaped;
+    }
+
+    void shaping_cache::insert(const text_key& key, const shaped_text& shaped)
+    {
+        if (capacity_ == 0) return;
+
+        if (const auto it = index_.find(key); it != index_.end())
+        {
+            it->second->shaped = shaped;
+            entries_.splice(entries_.begin(), entries_, it->second);
+            return;
+        }
+
+        if (entries_.size() >= capacity_)
+        {
+            const auto& oldest = entries_.back();
+            index_.erase(text_key{oldest.text, oldest.face_size, oldest.is_formula});
+            entries_.pop_back();
+        }
+
+        entries_.push_front(entry{std::string(key.text), key.face_size, key.is_formula, shaped});
+        const auto& front = entries_.front();
+        index_.emplace(text_key{front.text, front.face_size, front.is_formula}, entries_.begin());
+    }
+
+    void shaping_cache::clear()
+    {
+        index_.clear();
+        entries_.clear();
+        faces_.clear();
+        vertical_extents_.clear();
+        numeric_glyphs_.clear();
+        face_statistics_ = {};
+        text_statistics_ = {};
+        formula_statistics_ = {};
+        vertical_extent_statistics_ = {};
+        shaping_counts_ = {};
+    }
+}
@@ -75,20 +75,25 @@ namespace cdv::fnt
             return fontconfig_match(fc_config, pat.get(), properties);
         }
 
-        std::pair<std::vector<shaped_glyph>, pixel_pos>
-        shape_normal_text(const std::string& text, const pixels x_offset, freetype::face_t* ft_face)
+        using hb_buffer_ptr = std::unique_ptr<hb_buffer_t, decltype(&hb_buffer_destroy)>;
+
+        hb_buffer_ptr shape_with_harfbuzz(const std::string_view text, freetype::face_t* ft_face)
         {
-            using hb_buffer_ptr = std::unique_ptr<hb_buffer_t, decltype(&hb_buffer_destroy)>;
-            const auto hb_buffer = hb_buffer_ptr(hb_buffer_create(), hb_buffer_destroy);
+            auto hb_buffer = hb_buffer_ptr(hb_buffer_create(), hb_buffer_destroy);
             hb_buffer_set_direction(hb_buffer.get(), HB_DIRECTION_LTR);
             hb_buffer_set_script(hb_buffer.get(), HB_SCRIPT_LATIN);
             hb_buffer_set_language(hb_buffer.get(), hb_language_from_string("en", -1));
 
-            hb_buffer_add_utf8(hb_buffer.get(), text.c_str(), static_cast<int>(text.length()), 0,
+            hb_buffer_add_utf8(hb_buffer.get(), text.data(), static_cast<int>(text.length()), 0,
                                static_cast<int>(text.length()));
-            const auto hb_font = std::unique_ptr<hb_font_t, decltype(&hb_font_destroy)>(
-                hb_ft_font_create_referenced(ft_face), hb_font_destroy);
-            hb_shape(hb_font.get(), hb_buffer.get(), nullptr, 0);
+            hb_shape(freetype::hb_font(ft_face), hb_buffer.get(), nullptr, 0);
+            return hb_buffer;
+        }
+
+        std::pair<std::vector<shaped_glyph>, pixel_pos>
+        shape_normal_text(const std::string& text, const pixels x_offset, freetype::face_t* ft_face)
+        {
+            const auto hb_buffer = shape_with_harfbuzz(text, ft_face);
 
             pixel_pos extents{};
 
@@ -106,36 +111,157 @@ namespace cdv::fnt
                 x += fixpoint_26_6_to_pixels(glyph_pos[i].x_advance);
                 extents.x += fixpoint_26_6_to_pixels(glyph_pos[i].x_advance);
 
-                FT_Load_Glyph(ft_face, glyph_info[i].codepoint, FT_LOAD_DEFAULT);
-                extents.y = std::max(extents.y, fixpoint_26_6_to_pixels(ft_face->glyph->metrics.height));
+                const auto height = freetype::glyph_height(ft_face, glyph_info[i].codepoint);
+                extents.y = std::max(extents.y, fixpoint_26_6_to_pixels(height));
+            }
+
+            return {glyphs, extents};
+        }
+
+        // Shapes every character of the table on its own and in combination with every other character. The
+        // pairs must produce the same glyphs as the single characters and may only differ in the advance of
+        // the first glyph, otherwise the table can't reproduce the HarfBuzz output and is marked as unusable
+        numeric_glyph_table create_numeric_glyph_table(freetype::face_t* ft_face)
+        {
+            constexpr auto n = numeric_glyph_table::num_characters;
+            const auto& characters = numeric_glyph_table::characters;
+
+            numeric_glyph_table table;
+            for (auto i = 0u; i < n; ++i)
+            {
+                const auto hb_buffer = shape_with_harfbuzz(characters.substr(i, 1), ft_face);
+                unsigned int num_glyphs = 0;
+                const auto* glyph_pos = hb_buffer_get_glyph_positions(hb_buffer.get(), &num_glyphs);
+                const auto* glyph_info = hb_buffer_get_glyph_infos(hb_buffer.get(), &num_glyphs);
+                if (num_glyphs != 1) return table;
+
+                table.glyphs[i] = {.index = glyph_info[0].codepoint,
+                                   .x_offset = glyph_pos[0].x_offset,
+                                   .y_offset = glyph_pos[0].y_offset,
+                                   .advance = glyph_pos[0].x_advance};
+            }
+
+            const auto matches = [](const numeric_glyph_table::glyph& g, const hb_glyph_info_t& info,
+                                    const hb_glyph_position_t& pos) {
+                return (g.index == info.codepoint) && (g.x_offset == pos.x_offset) && (g.y_offset == pos.y_offset);
+            };
+
+            for (auto i = 0u; i < n; ++i)
+            {
+                for (auto j = 0u; j < n; ++j)
+                {
+                    const auto pair = std::string{characters[i], characters[j]};
+                    const auto hb_buffer = shape_with_harfbuzz(pair, ft_face);
+                    unsigned int num_glyphs = 0;
+                    const auto* glyph_pos = hb_buffer_get_glyph_positions(hb_buffer.get(), &num_glyphs);
+                    const auto* glyph_info = hb_buffer_get_glyph_infos(hb_buffer.get(), &num_glyphs);
+                    if ((num_glyphs != 2) || !matches(table.glyphs[i], glyph_info[0], glyph_pos[0]) ||
+                        !matches(table.glyphs[j], glyph_info[1], glyph_pos[1]) ||
+                        (glyph_pos[1].x_advance != table.glyphs[j].advance))
+                        return table;
+
+                    table.pair_advances[i][j] = glyph_pos[0].x_advance;
+                }
+            }
+
+            table.usable = true;
+            return table;
+        }
+
+        std::pair<std::vector<shaped_glyph>, pixel_pos>
+        shape_numeric_text(const std::string& text, const numeric_glyph_table& table, freetype::face_t* ft_face)
+        {
+            pixel_pos extents{};
+
+            auto x = 0_px;
+            std::vector<shaped_glyph> glyphs(text.size());
+            for (auto i = 0u; i < text.size(); ++i)
+            {
+                const auto slot = *numeric_glyph_table::slot(text[i]);
+                const auto& glyph = table.glyphs[slot];
+                const auto advance = (i + 1 < text.size())
+                                         ? table.pair_advances[slot][*numeric_glyph_table::slot(text[i + 1])]
+                                         : glyph.advance;
+
+                glyphs[i].index = glyph.index;
+                glyphs[i].pos.x = x + fixpoint_26_6_to_pixels(glyph.x_offset);
+                glyphs[i].pos.y = -fixpoint_26_6_to_pixels(glyph.y_offset);
+                x += fixpoint_26_6_to_pixels(advance);
+                extents.x += fixpoint_26_6_to_pixels(advance);
+
+                const auto height = freetype::glyph_height(ft_face, glyph.index);
+                extents.y = std::max(extents.y, fixpoint_26_6_to_pixels(height));
             }
 
             return {glyphs, extents};
         }
     }
 
-    text_shaper::text_shaper() : fc_config_(FcInitLoadConfigAndFonts())
-    {
-        if (!FcConfigAppFontAddDir(fc_config_, reinterpret_cast<const FcChar8*>(CDV_DATA_DIR "/fonts/ttf")))
-            throw std::runtime_error("Failed to add cdv font directory to fontconfig");
+    text_shaper::text_shaper() : text_shaper(font_context::shared()) {}
 
+    text_shaper::text_shaper(std::shared_ptr<font_context> context) : context_(std::move(context))
+    {
         select_face({.family = "sans-serif"}, 12_pt);
     }
 
     void text_shaper::select_face(const font_properties& properties, const points size)
     {
-        auto [file_name, face_index] = fontconfig_select_face(fc_config_, properties, size);
-        face_ = &freetype_.face(file_name, face_index);
+        const auto lock = context_->lock();
+        auto& cache = context_->cache();
+        if (auto* face = cache.find_face(properties, size))
+        {
+            face_ = face;
+            return;
+        }
+
+        auto [file_name, face_index] = fontconfig_select_face(context_->fontconfig(), properties, size);
+        face_ = &context_->ft().face(file_name, face_index);
+        cache.insert_face(properties, size, face_);
     }
 
     shaped_text text_shaper::shape(const std::string& text, const points size, const dots_per_inch dpi) const
+    {
+        const auto lock = context_->lock();
+        auto& cache = context_->cache();
+        if (const auto* cached = cache.find_text(text, face_, size, dpi)) return *cached;
+
+        auto result = shape_uncached(text, size, dpi);
+        cache.insert_text(text, face_, size, dpi, result);
+        return result;
+    }
+
+    pixels text_shaper::vertical_extent(const points size, const dots_per_inch dpi) const
+    {
+        const auto lock = context_->lock();
+        auto& cache = context_->cache();
+        if (const auto extent = cache.find_vertical_extent(face_, size, dpi)) return *extent;
+
+        const auto result = shape_uncached("My", size, dpi).extents().y;
+        cache.insert_vertical_extent(face_, size, dpi, result);
+        return result;
+    }
+
+    const numeric_glyph_table& text_shaper::numeric_glyph_table_for(const points size, const dots_per_inch dpi) const
+    {
+        auto& cache = context_->cache();
+        if (const auto* table = cache.find_numeric_glyphs(face_, size, dpi)) return *table;
+
+        return cache.insert_numeric_glyphs(face_, size, dpi, create_numeric_glyph_table(face_));
+    }
+
+    shaped_text text_shaper::shape_uncached(const std::string& text, const points size, const dots_per_inch dpi) const
     {
         freetype::set_size(face_, size, dpi);
 
         shaped_text result;
         if (ranges::count(text, '$') < 2)
         {
-            auto [glyphs, extents] = shape_normal_text(text, 0_px, face_);
+            const auto* numeric_glyphs = numeric_glyph_table::is_numeric(text) ? &numeric_glyph_table_for(size, dpi)
+                                                                                : nullptr;
+            const auto use_numeric_glyphs = (numeric_glyphs != nullptr) && numeric_glyphs->usable;
+            context_->cache().count_shaping(use_numeric_glyphs);
+            auto [glyphs, extents] = use_numeric_glyphs ? shape_numeric_text(text, *numeric_glyphs, face_)
+                                                        : shape_normal_text(text, 0_px, face_);
             result.runs_.emplace_back(
                 shaped_text_run{.font_size = size, .freetype_face = face_, .glyphs = std::move(glyphs)});
             result.extents_ = extents;
@@ -159,6 +285,7 @@ namespace cdv::fnt
             else
             {
                 const auto substring = text.substr(substring_start, substring_end - substring_start);
+                context_->cache().count_shaping(false);
                 auto [glyphs, extents] = shape_normal_text(substring, total_extents.x, face_);
                 result.runs_.emplace_back(
                     shaped_text_run{.font_size = size, .freetype_face = face_, .glyphs = std::move(glyphs)});
@@ -174,41 +301,74 @@ namespace cdv::fnt
 
     pixel_pos text_shaper::shape_mathematical_formula(const std::string& text, const points size, const pixels x_offset,
                                                       const dots_per_inch dpi, shaped_text& result) const
+    {
+        const auto append_runs = [&](const shaped_text& formula) {
+            for (auto run : formula.runs())
+            {
+                for (auto& glyph : run.glyphs)
+                    glyph.pos.x += x_offset;
+
+                for (auto& line : run.lines)
+                {
+                    line.min.x += x_offset;
+                    line.max.x += x_offset;
+                }
+
+                result.runs_.push_back(std::move(run));
+            }
+
+            return formula.extents();
+        };
+
+        auto& cache = context_->cache();
+        if (const auto* cached = cache.find_formula(text, size, dpi)) return append_runs(*cached);
+
+        const auto layout = layout_mathematical_formula(text, size, dpi);
+        cache.insert_formula(text, size, dpi, layout);
+        return append_runs(layout);
+    }
+
+    shaped_text text_shaper::layout_mathematical_formula(const std::string& text, const points size,
+                                                         const dots_per_inch dpi) const
     {
         const auto create_font_face = [&](const mfl::font_family family) {
-            return std::make_unique<mfl_font_face>(family, freetype_);
+            return std::make_unique<mfl_font_face>(family, context_->ft(), context_->math_faces());
         };
 
         auto elements = mfl::layout(text.substr(1, text.length() - 2), size, create_font_face);
         if (elements.error) throw std::runtime_error(*elements.error);
 
+        shaped_text result;
         for (const auto glyph : elements.glyphs)
         {
-            shaped_text_run run;
-            if (!elements.lines.empty())
-            {
-                run.lines.reserve(elements.lines.size());
-                for (const auto line : elements.lines)
-                {
-                    shaped_line l;
-                    l.min.x = x_offset + mfl::points_to_pixels(line.x, dpi);
-                    l.min.y = -mfl::points_to_pixels(line.y, dpi);
-                    l.max.x = l.min.x + mfl::points_to_pixels(line.length, dpi);
-                    l.max.y = l.min.y - mfl::points_to_pixels(line.thickness, dpi);
-                    run.lines.push_back(l);
-                }
-                elements.lines.clear();
-            }
-
-            run.font_size = glyph.size;
-            run.freetype_face = &freetype_.face(glyph.family);
-            const auto x = x_offset + mfl::points_to_pixels(glyph.x, dpi);
+            auto* face = &context_->ft().face(glyph.family);
+            const auto x = mfl::points_to_pixels(glyph.x, dpi);
             const auto y = -mfl::points_to_pixels(glyph.y, dpi);
-            run.glyphs.emplace_back(shaped_glyph{.index = glyph.index, .pos = pixel_pos{x, y}});
 
-            result.runs_.emplace_back(std::move(run));
+            const auto continues_last_run = !result.runs_.empty() && (result.runs_.back().freetype_face == face) &&
+                                            (result.runs_.back().font_size == glyph.size);
+            if (!continues_last_run)
+                result.runs_.emplace_back(shaped_text_run{.font_size = glyph.size, .freetype_face = face});
+
+            result.runs_.back().glyphs.emplace_back(shaped_glyph{.index = glyph.index, .pos = pixel_pos{x, y}});
         }
 
-        return {mfl::points_to_pixels(elements.width, dpi), mfl::points_to_pixels(elements.height, dpi)};
+        if (!result.runs_.empty() && !elements.lines.empty())
+        {
+            auto& lines = result.runs_.front().lines;
+            lines.reserve(elements.lines.size());
+            for (const auto line : elements.lines)
+            {
+                shaped_line l;
+                l.min.x = mfl::points_to_pixels(line.x, dpi);
+                l.min.y = -mfl::points_to_pixels(line.y, dpi);
+                l.max.x = l.min.x + mfl::points_to_pixels(line.length, dpi);
+                l.max.y = l.min.y - mfl::points_to_pixels(line.thickness, dpi);
+                lines.push_back(l);
+            }
+        }
+
+        result.extents_ = {mfl::points_to_pixels(elements.width, dpi), mfl::points_to_pixels(elements.height, dpi)};
+        return result;
     }
-}
\ No newline at end of file
+}
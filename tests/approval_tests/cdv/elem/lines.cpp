@@ -3,8 +3,20 @@
 #include <cdv/elem/line.hpp>
 #include <cdv/elem/text.hpp>
 #include <cdv/fig/frame.hpp>
+#include <cdv/fig/render_image.hpp>
 #include <cdv/fig/render_svg.hpp>
 
+#include <range/v3/range/conversion.hpp>
+#include <range/v3/view/transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <utility>
+#include <vector>
+
 namespace cdv::elem
 {
     namespace
@@ -51,4 +63,87 @@ namespace cdv::elem
 
         test::approve_svg(fig::render_to_svg_string(frame.dimensions(), miter, round, bevel));
     }
+
+    TEST_CASE("decimated lines")
+    {
+        constexpr auto frame = fig::frame();
+        const auto dimensions = frame.dimensions();
+        const auto width = static_cast<size_t>(dimensions.width.value());
+        const auto height = static_cast<size_t>(dimensions.height.value());
+        const auto stride = fig::image_stride(dimensions);
+
+        // a dense sine wave and white noise with many more points than pixels
+        constexpr auto num_points = 200'000;
+        std::mt19937 rng(42);
+        std::normal_distribution<double> noise(0.0, 1.0);
+        std::vector<pixels> xs;
+        std::vector<pixels> sine_ys;
+        std::vector<pixels> noise_ys;
+        for (auto i = 0; i < num_points; ++i)
+        {
+            const auto t = i / double(num_points - 1);
+            xs.push_back(frame.x0() + t * frame.inner_width());
+            sine_ys.push_back(frame.y_center() + 0.4 * std::sin(300.0 * t) * frame.inner_height());
+            noise_ys.push_back(frame.y_center() + 0.15 * std::clamp(noise(rng), -3.0, 3.0) * frame.inner_height());
+        }
+
+        const auto render = [&](const auto& ln) {
+            std::vector<unsigned char> buffer(height * static_cast<size_t>(stride));
+            fig::render_to_image_buffer(buffer.data(), stride, dimensions, ln);
+            return buffer;
+        };
+
+        // the line is black, so the alpha channel is all there is to compare
+        const auto alpha = [&](const std::vector<unsigned char>& buffer, const size_t x, const size_t y) {
+            std::uint32_t pixel = 0;
+            std::memcpy(&pixel, buffer.data() + y * static_cast<size_t>(stride) + 4 * x, sizeof(pixel));
+            return static_cast<int>(pixel >> 24);
+        };
+
+        // the summed alpha difference relative to the coverage of the full line and the fraction of the drawn
+        // pixels that changed by more than a quarter
+        const auto compare = [&](const std::vector<unsigned char>& full, const std::vector<unsigned char>& decimated) {
+            auto coverage = 0.0;
+            auto difference = 0.0;
+            size_t num_drawn = 0;
+            size_t num_changed = 0;
+            for (size_t y = 0; y < height; ++y)
+            {
+                for (size_t x = 0; x < width; ++x)
+                {
+                    const auto a = alpha(full, x, y);
+                    const auto b = alpha(decimated, x, y);
+                    coverage += a;
+                    difference += std::abs(a - b);
+                    if ((a != 0) || (b != 0)) ++num_drawn;
+                    if (std::abs(a - b) > 64) ++num_changed;
+                }
+            }
+
+            REQUIRE_GT(coverage, 0.0);
+            return std::pair{difference / coverage, double(num_changed) / double(num_drawn)};
+        };
+
+        // Quarter pixel columns differ by about 0.4% (sine) and 0.1% (noise), whole pixel columns by about 5% and
+        // 1.8%, so the limits tell the two apart
+        constexpr auto max_difference = 0.006;
+        constexpr auto max_changed = 0.001;
+        for (const auto* ys : {&sine_ys, &noise_ys})
+        {
+            const auto full = render(line(xs, *ys));
+
+            const auto [difference, changed] = compare(full, render(line(xs, *ys, {}, line_decimation::m4)));
+            CHECK_LT(difference, max_difference);
+            CHECK_LT(changed, max_changed);
+
+            std::vector<pixel_pos> positions;
+            for (size_t i = 0; i < xs.size(); ++i)
+                positions.emplace_back(xs[i], (*ys)[i]);
+
+            const auto whole_pixels = detail::m4_decimate(positions, 1.0);
+            const auto whole_pixel_xs = whole_pixels | rv::transform(&pixel_pos::x) | ::ranges::to_vector;
+            const auto whole_pixel_ys = whole_pixels | rv::transform(&pixel_pos::y) | ::ranges::to_vector;
+            CHECK_GT(compare(full, render(line(whole_pixel_xs, whole_pixel_ys))).first, max_difference);
+        }
+    }
 }
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cdv/core/color/categorical_schemes.hpp>
+#include <cdv/core/color/single_hue_interpolators.hpp>
+#include <cdv/elem/axis.hpp>
+#include <cdv/elem/line.hpp>
+#include <cdv/elem/rectangle.hpp>
+#include <cdv/fig/frame.hpp>
+#include <cdv/scl/band_scale.hpp>
+#include <cdv/scl/linear_scale.hpp>
+#include <cdv/scl/ordinal_scale.hpp>
+#include <cdv/scl/sequential_scale.hpp>
+
+#include <range/v3/range/conversion.hpp>
+#include <range/v3/view/cartesian_product.hpp>
+#include <range/v3/view/generate_n.hpp>
+#include <range/v3/view/iota.hpp>
+#include <range/v3/view/linear_distribute.hpp>
+#include <range/v3/view/transform.hpp>
+
+#include <array>
+#include <random>
+
+namespace cdv::bench
+{
+    // The "full chart no grid" line chart and the "simple heatmap" from the approval tests, so that the benchmarks
+    // measure the output of realistic figures
+    enum approval_figure
+    {
+        line_chart,
+        heatmap,
+        num_approval_figures
+    };
+
+    template <typename Surface>
+    void draw_line_chart(const fig::frame& frame, Surface& surface)
+    {
+        namespace rv = ranges::views;
+
+        const auto extents = pixel_pos{frame.width, frame.height};
+        const auto x1 = rv::linear_distribute(0.0, 2.0, 100);
+        const auto x2 = x1 | rv::transform([](auto x) { return x * x; });
+        const auto x3 = x1 | rv::transform([](auto x) { return x * x * x; });
+
+        const auto x = scl::linear_scale(0.0, 2.0, frame.x0(), frame.x1());
+        const auto y = scl::linear_scale(0.0, 8.0, frame.y0(), frame.y1());
+
+        const auto keys = std::array{"$x$", "$x^2$", "$x^3$"};
+        const auto color = scl::ordinal_scale(keys, scheme::original_tableau10);
+        draw(elem::bottom_axis(x, frame.y0()), surface, extents);
+        draw(elem::left_axis(y, frame.x0()), surface, extents);
+        const auto draw_line = [&](const auto& ys, const char* key) {
+            const auto line = elem::line{
+                .xs = x1 | rv::transform(x), .ys = ys | rv::transform(y), .properties = {.color = color(key)}};
+            draw(line, surface, extents);
+        };
+        draw_line(x1, keys[0]);
+        draw_line(x2, keys[1]);
+        draw_line(x3, keys[2]);
+    }
+
+    template <typename Surface>
+    void draw_heatmap(const fig::frame& frame, Surface& surface)
+    {
+        namespace rv = ranges::views;
+
+        const auto extents = pixel_pos{frame.width, frame.height};
+        const auto num_rows = 10;
+        const auto num_cols = 12;
+
+        const auto xs = rv::iota(0, num_cols);
+        const auto ys = rv::iota(0, num_rows);
+
+        const auto x = scl::band_scale(xs, frame.x0(), frame.x1());
+        const auto y = scl::band_scale(ys, frame.y0(), frame.y1());
+        const auto color = scl::sequential_scale(0.0, 10.0, interpolator::blues);
+
+        std::uniform_real_distribution<double> dist(0.0, 10.0);
+        std::mt19937 rng(42);
+        const auto values = rv::generate_n([&] { return dist(rng); }, num_rows * num_cols) | ranges::to_vector;
+
+        for (const auto [xkey, ykey] : rv::cartesian_product(xs, ys))
+        {
+            const auto value = values[size_t(ykey * num_cols + xkey)];
+            draw(elem::rectangle{.min = {x.min(xkey), y.min(ykey)},
+                                 .max = {x.max(xkey), y.max(ykey)},
+                                 .fill = {.color = color(value)}},
+                 surface, extents);
+        }
+
+        draw(elem::bottom_axis(x, frame.y0()), surface, extents);
+        draw(elem::left_axis(y, frame.x0()), surface, extents);
+    }
+
+    template <typename Surface>
+    void draw_approval_figure(const approval_figure figure, const fig::frame& frame, Surface& surface)
+    {
+        if (figure == line_chart)
+            draw_line_chart(frame, surface);
+        else
+            draw_heatmap(frame, surface);
+    }
+}
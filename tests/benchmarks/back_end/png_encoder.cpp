@@ -0,0 +1,93 @@
+#include <approval_figures.hpp>
+#include <cdv/back_end/cairo.hpp>
+#include <cdv/back_end/png_encoder.hpp>
+#include <cdv/fig/frame.hpp>
+#include <cdv/fig/render_surface.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <vector>
+
+namespace cdv::back_end
+{
+    namespace
+    {
+        using surface_t = fig::render_surface<cairo>;
+
+        // the approval test figures drawn at the default frame size and at four times that size
+        constexpr auto num_figures = 2 * bench::num_approval_figures;
+
+        constexpr auto frame_for(const int id)
+        {
+            constexpr auto large_frame = fig::frame{.width = pixels(2560.0), .height = pixels(1920.0)};
+            return (id < bench::num_approval_figures) ? fig::frame() : large_frame;
+        }
+
+        surface_t& rendered_figure(const int id)
+        {
+            static const auto surfaces = [] {
+                std::vector<std::unique_ptr<surface_t>> result;
+                for (auto i = 0; i < num_figures; ++i)
+                {
+                    const auto frame = frame_for(i);
+                    auto& surface = *result.emplace_back(
+                        std::make_unique<surface_t>(cairo(frame.width, frame.height), frame.dpi));
+                    bench::draw_approval_figure(bench::approval_figure(i % bench::num_approval_figures), frame, surface);
+                }
+
+                return result;
+            }();
+
+            return *surfaces[size_t(id)];
+        }
+
+        void png_cairo(benchmark::State& state)
+        {
+            auto& surface = rendered_figure(static_cast<int>(state.range(0)));
+            size_t size = 0;
+            for (auto _ : state)
+            {
+                std::vector<unsigned char> png;
+                surface.to_png(png);
+                size = png.size();
+            }
+
+            state.counters["bytes"] = static_cast<double>(size);
+        }
+
+        // arguments: figure, compression level, filter, threads
+        void png_encoder(benchmark::State& state)
+        {
+            auto& surface = rendered_figure(static_cast<int>(state.range(0)));
+            const auto options = png_options{.compression_level = static_cast<int>(state.range(1)),
+                                             .filter = static_cast<png_filter>(state.range(2)),
+                                             .num_threads = static_cast<size_t>(state.range(3))};
+            size_t size = 0;
+            for (auto _ : state)
+            {
+                std::vector<unsigned char> png;
+                encode_png(surface.image(), png, options);
+                size = png.size();
+            }
+
+            state.counters["bytes"] = static_cast<double>(size);
+        }
+
+        void png_encoder_arguments(benchmark::internal::Benchmark* benchmark)
+        {
+            for (auto figure = 0; figure < num_figures; ++figure)
+            {
+                for (const auto level : {1, 6})
+                    for (const auto filter : {png_filter::none, png_filter::up, png_filter::adaptive})
+                        benchmark->Args({figure, level, static_cast<int>(filter), 1});
+
+                for (const auto threads : {2, 4, 8})
+                    benchmark->Args({figure, 6, static_cast<int>(png_filter::adaptive), threads});
+            }
+        }
+    }
+
+    BENCHMARK(png_cairo)->DenseRange(0, num_figures - 1)->Unit(benchmark::kMillisecond);
+    BENCHMARK(png_encoder)->Apply(png_encoder_arguments)->Unit(benchmark::kMillisecond)->UseRealTime();
+}
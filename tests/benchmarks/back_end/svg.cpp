@@ -0,0 +1,72 @@
+#include <approval_figures.hpp>
+#include <cdv/back_end/cairo.hpp>
+#include <cdv/back_end/svg.hpp>
+#include <cdv/fig/frame.hpp>
+#include <cdv/fig/render_surface.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <sstream>
+
+namespace cdv::back_end
+{
+    namespace
+    {
+        template <typename BackEnd, typename... Options>
+        void render_svg(benchmark::State& state, const Options&... options)
+        {
+            constexpr auto frame = fig::frame();
+            const auto figure = bench::approval_figure(state.range(0));
+            size_t size = 0;
+            for (auto _ : state)
+            {
+                std::ostringstream os;
+                fig::render_surface<BackEnd> surface(BackEnd(frame.width, frame.height, os, options...), frame.dpi);
+                bench::draw_approval_figure(figure, frame, surface);
+                surface.finish();
+                size = os.str().size();
+            }
+
+            state.counters["bytes"] = static_cast<double>(size);
+        }
+
+        void svg_cairo(benchmark::State& state) { render_svg<cairo>(state); }
+
+        void svg_native(benchmark::State& state) { render_svg<svg>(state); }
+
+        // the bytes counters show what each of the compact options saves on its own compared to svg_native
+        void svg_precision_2(benchmark::State& state) { render_svg<svg>(state, svg_options{.precision = 2}); }
+
+        void svg_relative_path_commands(benchmark::State& state)
+        {
+            render_svg<svg>(state, svg_options{.relative_path_commands = true});
+        }
+
+        void svg_shared_styles(benchmark::State& state) { render_svg<svg>(state, svg_options{.shared_styles = true}); }
+
+        void svg_merge_paths(benchmark::State& state) { render_svg<svg>(state, svg_options{.merge_paths = true}); }
+
+        void svg_gzip(benchmark::State& state) { render_svg<svg>(state, svg_options{.gzip = true}); }
+
+        void svg_compact(benchmark::State& state) { render_svg<svg>(state, svg_options::compact()); }
+
+        void svg_compact_gzip(benchmark::State& state)
+        {
+            auto options = svg_options::compact();
+            options.gzip = true;
+            render_svg<svg>(state, options);
+        }
+    }
+
+    BENCHMARK(svg_cairo)->DenseRange(0, bench::num_approval_figures - 1)->Unit(benchmark::kMicrosecond);
+    BENCHMARK(svg_native)->DenseRange(0, bench::num_approval_figures - 1)->Unit(benchmark::kMicrosecond);
+    BENCHMARK(svg_precision_2)->DenseRange(0, bench::num_approval_figures - 1)->Unit(benchmark::kMicrosecond);
+    BENCHMARK(svg_relative_path_commands)
+        ->DenseRange(0, bench::num_approval_figures - 1)
+        ->Unit(benchmark::kMicrosecond);
+    BENCHMARK(svg_shared_styles)->DenseRange(0, bench::num_approval_figures - 1)->Unit(benchmark::kMicrosecond);
+    BENCHMARK(svg_merge_paths)->DenseRange(0, bench::num_approval_figures - 1)->Unit(benchmark::kMicrosecond);
+    BENCHMARK(svg_gzip)->DenseRange(0, bench::num_approval_figures - 1)->Unit(benchmark::kMicrosecond);
+    BENCHMARK(svg_compact)->DenseRange(0, bench::num_approval_figures - 1)->Unit(benchmark::kMicrosecond);
+    BENCHMARK(svg_compact_gzip)->DenseRange(0, bench::num_approval_figures - 1)->Unit(benchmark::kMicrosecond);
+}
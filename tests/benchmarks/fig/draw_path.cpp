@@ -0,0 +1,133 @@
+#include <cdv/back_end/cairo.hpp>
+#include <cdv/elem/line.hpp>
+#include <cdv/elem/min_max_pyramid.hpp>
+#include <cdv/fig/frame.hpp>
+#include <cdv/fig/render_surface.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <utility>
+#include <vector>
+
+namespace cdv::fig
+{
+    namespace
+    {
+        constexpr auto chart_frame = frame();
+
+        // a sine wave across the whole frame with one vertex per item
+        elem::line<std::vector<pixels>, std::vector<pixels>> sine_line(const benchmark::State& state)
+        {
+            const auto num_points = static_cast<size_t>(state.range(0));
+            std::vector<pixels> xs(num_points);
+            std::vector<pixels> ys(num_points);
+            for (size_t i = 0; i < num_points; ++i)
+            {
+                const auto t = double(i) / double(num_points - 1);
+                xs[i] = chart_frame.x0() + t * chart_frame.inner_width();
+                ys[i] = chart_frame.y0() + (0.5 + 0.5 * std::sin(100.0 * t)) * chart_frame.inner_height();
+            }
+
+            return {.xs = std::move(xs), .ys = std::move(ys)};
+        }
+
+        // every vertex is a separate call to the back end
+        void draw_path_per_vertex(benchmark::State& state)
+        {
+            const auto line = sine_line(state);
+            render_surface<back_end::cairo> surface(back_end::cairo(chart_frame.width, chart_frame.height),
+                                                    chart_frame.dpi);
+            for (auto _ : state)
+            {
+                surface.move_to({line.xs.front(), line.ys.front()});
+                for (size_t i = 1; i < line.xs.size(); ++i)
+                    surface.line_to({line.xs[i], line.ys[i]});
+
+                surface.stroke();
+            }
+
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+
+        // the line element, which hands the whole path to the back end at once
+        void draw_line(benchmark::State& state)
+        {
+            const auto line = sine_line(state);
+            const auto extents = pixel_pos{chart_frame.width, chart_frame.height};
+            render_surface<back_end::cairo> surface(back_end::cairo(chart_frame.width, chart_frame.height),
+                                                    chart_frame.dpi);
+            for (auto _ : state)
+                draw(line, surface, extents);
+
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+
+        // the line element with m4 decimation, which only hands a few vertices per pixel column to the back end
+        void draw_line_m4(benchmark::State& state)
+        {
+            auto line = sine_line(state);
+            line.decimation = elem::line_decimation::m4;
+            const auto extents = pixel_pos{chart_frame.width, chart_frame.height};
+            render_surface<back_end::cairo> surface(back_end::cairo(chart_frame.width, chart_frame.height),
+                                                    chart_frame.dpi);
+            for (auto _ : state)
+                draw(line, surface, extents);
+
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+
+        // a line made from a precomputed min max pyramid, zooming in on a different half of the series each time
+        void draw_line_pyramid(benchmark::State& state)
+        {
+            const auto line = sine_line(state);
+            const auto pyramid = elem::min_max_pyramid(line.xs, line.ys);
+            const auto extents = pixel_pos{chart_frame.width, chart_frame.height};
+            const auto identity = [](const pixels p) { return p; };
+            render_surface<back_end::cairo> surface(back_end::cairo(chart_frame.width, chart_frame.height),
+                                                    chart_frame.dpi);
+            size_t i = 0;
+            for (auto _ : state)
+            {
+                const auto x0 = line.xs[(i++ % 4) * line.xs.size() / 8];
+                const auto x1 = x0 + 0.5 * chart_frame.inner_width();
+                draw(pyramid.make_line(x0, x1, identity, identity), surface, extents);
+            }
+
+            state.SetItemsProcessed(state.iterations() * state.range(0) / 2);
+        }
+
+        // the line element simplified with a tolerance of a quarter pixel
+        void draw_line_simplified(benchmark::State& state)
+        {
+            using namespace units_literals;
+            auto line = sine_line(state);
+            line.simplification.tolerance = 0.25_px;
+            const auto extents = pixel_pos{chart_frame.width, chart_frame.height};
+            render_surface<back_end::cairo> surface(back_end::cairo(chart_frame.width, chart_frame.height),
+                                                    chart_frame.dpi);
+            for (auto _ : state)
+                draw(line, surface, extents);
+
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+    }
+
+    BENCHMARK(draw_path_per_vertex)->RangeMultiplier(32)->Range(1 << 10, 1 << 20)->Unit(benchmark::kMillisecond);
+    BENCHMARK(draw_line)
+        ->RangeMultiplier(32)
+        ->Range(1 << 10, 1 << 20)
+        ->Arg(10'000'000)
+        ->Unit(benchmark::kMillisecond);
+    BENCHMARK(draw_line_m4)
+        ->RangeMultiplier(32)
+        ->Range(1 << 10, 1 << 20)
+        ->Arg(10'000'000)
+        ->Unit(benchmark::kMillisecond);
+    BENCHMARK(draw_line_pyramid)
+        ->RangeMultiplier(32)
+        ->Range(1 << 10, 1 << 20)
+        ->Arg(10'000'000)
+        ->Unit(benchmark::kMillisecond);
+    BENCHMARK(draw_line_simplified)->RangeMultiplier(32)->Range(1 << 10, 1 << 20)->Unit(benchmark::kMillisecond);
+}
@@ -0,0 +1,112 @@
+#include <cdv/elem/axis.hpp>
+#include <cdv/elem/line.hpp>
+#include <cdv/fig/frame.hpp>
+#include <cdv/fig/render_batch.hpp>
+#include <cdv/scl/linear_scale.hpp>
+
+#include <benchmark/benchmark.h>
+#include <range/v3/range/conversion.hpp>
+#include <range/v3/view/iota.hpp>
+#include <range/v3/view/transform.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace cdv::fig
+{
+    namespace
+    {
+        namespace rv = ranges::views;
+
+        constexpr auto num_figures = 256;
+
+        constexpr auto chart_frame = frame{.width = pixels(320.0), .height = pixels(240.0)};
+
+        // a sine wave with its own frequency plus axes
+        auto small_chart(const int i)
+        {
+            const auto x = scl::linear_scale(0.0, 1.0, chart_frame.x0(), chart_frame.x1());
+            const auto y = scl::linear_scale(-1.0, 1.0, chart_frame.y0(), chart_frame.y1());
+            const auto ts = rv::iota(0, 200) | rv::transform([](const int j) { return j / 199.0; });
+            auto xs = ts | rv::transform(x) | ranges::to_vector;
+            auto ys = ts | rv::transform([&](const double t) { return y(std::sin(t * (i + 1))); }) | ranges::to_vector;
+            return std::tuple{elem::bottom_axis(x, chart_frame.y0()), elem::left_axis(y, chart_frame.x0()),
+                              elem::line{std::move(xs), std::move(ys)}};
+        }
+
+        auto small_charts()
+        {
+            std::vector<decltype(small_chart(0))> result;
+            for (auto i = 0; i < num_figures; ++i)
+                result.push_back(small_chart(i));
+
+            return result;
+        }
+
+        void render_svg_batch(benchmark::State& state)
+        {
+            const auto dimensions = chart_frame.dimensions();
+            const auto charts = small_charts();
+            const auto options = batch_options{.num_threads = static_cast<size_t>(state.range(0))};
+            for (auto _ : state)
+                benchmark::DoNotOptimize(render_batch_to_svg_strings(dimensions, charts, options));
+
+            state.SetItemsProcessed(state.iterations() * num_figures);
+        }
+
+        // every thread has its own font context, so text and finishing the output don't wait for a shared lock
+        void render_svg_batch_own_contexts(benchmark::State& state)
+        {
+            const auto dimensions = chart_frame.dimensions();
+            const auto charts = small_charts();
+            const auto options = batch_options{.num_threads = static_cast<size_t>(state.range(0)),
+                                               .context_factory = [] { return std::make_shared<fnt::font_context>(); }};
+            for (auto _ : state)
+                benchmark::DoNotOptimize(render_batch_to_svg_strings(dimensions, charts, options));
+
+            state.SetItemsProcessed(state.iterations() * num_figures);
+        }
+
+        void render_png_batch(benchmark::State& state)
+        {
+            const auto dimensions = chart_frame.dimensions();
+            const auto charts = small_charts();
+            const auto options = batch_options{.num_threads = static_cast<size_t>(state.range(0))};
+            for (auto _ : state)
+                benchmark::DoNotOptimize(render_batch_to_png_buffers(dimensions, charts, options));
+
+            state.SetItemsProcessed(state.iterations() * num_figures);
+        }
+
+        void render_png_batch_own_contexts(benchmark::State& state)
+        {
+            const auto dimensions = chart_frame.dimensions();
+            const auto charts = small_charts();
+            const auto options = batch_options{.num_threads = static_cast<size_t>(state.range(0)),
+                                               .context_factory = [] { return std::make_shared<fnt::font_context>(); }};
+            for (auto _ : state)
+                benchmark::DoNotOptimize(render_batch_to_png_buffers(dimensions, charts, options));
+
+            state.SetItemsProcessed(state.iterations() * num_figures);
+        }
+
+        // 1, 2 and 4 threads and one per hardware thread
+        void thread_counts(benchmark::internal::Benchmark* b)
+        {
+            const auto n = static_cast<int64_t>(std::thread::hardware_concurrency());
+            for (const int64_t num_threads : {int64_t(1), int64_t(2), int64_t(4)})
+                b->Arg(num_threads);
+
+            if (n > 4) b->Arg(n);
+        }
+    }
+
+    BENCHMARK(render_svg_batch)->Apply(thread_counts)->UseRealTime()->Unit(benchmark::kMillisecond);
+    BENCHMARK(render_svg_batch_own_contexts)->Apply(thread_counts)->UseRealTime()->Unit(benchmark::kMillisecond);
+    BENCHMARK(render_png_batch)->Apply(thread_counts)->UseRealTime()->Unit(benchmark::kMillisecond);
+    BENCHMARK(render_png_batch_own_contexts)->Apply(thread_counts)->UseRealTime()->Unit(benchmark::kMillisecond);
+}
@@ -0,0 +1,61 @@
+#include <cdv/back_end/cairo.hpp>
+#include <cdv/elem/axis.hpp>
+#include <cdv/elem/line.hpp>
+#include <cdv/elem/text.hpp>
+#include <cdv/fig/draw.hpp>
+#include <cdv/fig/frame.hpp>
+#include <cdv/fig/render_surface.hpp>
+#include <cdv/scl/linear_scale.hpp>
+
+#include <benchmark/benchmark.h>
+#include <range/v3/view/linear_distribute.hpp>
+#include <range/v3/view/transform.hpp>
+
+#include <sstream>
+#include <string>
+
+namespace cdv::fig
+{
+    namespace
+    {
+        namespace rv = ranges::views;
+        using namespace units_literals;
+
+        // the time from nothing to the first rendered svg - every iteration starts with a new font context,
+        // so this includes the fontconfig setup and the loading of all the faces that the chart needs
+        void first_line_chart_svg(benchmark::State& state, const std::string& title)
+        {
+            constexpr auto f = frame();
+            const auto x = scl::linear_scale(0.0, 2.0, f.x0(), f.x1());
+            const auto y = scl::linear_scale(0.0, 4.0, f.y0(), f.y1());
+            const auto xs = rv::linear_distribute(0.0, 2.0, 100);
+            const auto square = [&](const double v) { return y(v * v); };
+            const auto line = elem::line{.xs = xs | rv::transform(x), .ys = xs | rv::transform(square)};
+            const auto text = elem::text{.string = title, .pos = {f.x0() + 20_px, f.y1() - 20_px}};
+            const auto extents = pixel_pos{f.width, f.height};
+
+            for (auto _ : state)
+            {
+                const auto context = std::make_shared<fnt::font_context>();
+                std::ostringstream os;
+                {
+                    auto surface =
+                        render_surface<back_end::cairo>(back_end::cairo(extents.x, extents.y, os), f.dpi, context);
+                    draw(elem::bottom_axis(x, f.y0()), surface, extents);
+                    draw(elem::left_axis(y, f.x0()), surface, extents);
+                    draw(line, surface, extents);
+                    draw(text, surface, extents);
+                    surface.finish();
+                }
+
+                benchmark::DoNotOptimize(os.str());
+            }
+        }
+
+        void first_plain_line_chart_svg(benchmark::State& state) { first_line_chart_svg(state, "squares"); }
+        void first_math_line_chart_svg(benchmark::State& state) { first_line_chart_svg(state, "$y = x^2$"); }
+    }
+
+    BENCHMARK(first_plain_line_chart_svg)->Unit(benchmark::kMillisecond);
+    BENCHMARK(first_math_line_chart_svg)->Unit(benchmark::kMillisecond);
+}
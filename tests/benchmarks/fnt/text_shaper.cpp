@@ -0,0 +1,100 @@
+#include <cdv/fnt/text_shaper.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace cdv::fnt
+{
+    namespace
+    {
+        using namespace units_literals;
+
+        std::string long_label(const int64_t num_characters)
+        {
+            const auto sentence = std::string("The quick brown fox jumps over the lazy dog. ");
+            std::string result;
+            while (static_cast<int64_t>(result.size()) < num_characters)
+                result += sentence;
+
+            result.resize(static_cast<size_t>(num_characters));
+            return result;
+        }
+
+        // measures the complete shaping of a label without the shaped text cache, so every iteration goes
+        // through HarfBuzz and the glyph metrics lookup
+        void shape_long_label(benchmark::State& state)
+        {
+            const auto context = std::make_shared<font_context>(font_context_options{.shaped_text_cache_capacity = 0});
+            const auto shaper = text_shaper(context);
+            const auto label = long_label(state.range(0));
+            for (auto _ : state)
+                benchmark::DoNotOptimize(shaper.shape(label, 12_pt, 100_dpi));
+
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+
+        // tick labels are shaped from the numeric glyph table, the same labels with a trailing letter go
+        // through HarfBuzz
+        void shape_tick_labels(benchmark::State& state, const std::string& suffix)
+        {
+            const auto context = std::make_shared<font_context>(font_context_options{.shaped_text_cache_capacity = 0});
+            const auto shaper = text_shaper(context);
+            const auto labels = std::array{"0.0", "2.5", "5.0", "7.5", "10.0", "12.5", "-1.25", "1e+06"};
+            for (auto _ : state)
+            {
+                for (const auto* label : labels)
+                    benchmark::DoNotOptimize(shaper.shape(label + suffix, 12_pt, 100_dpi));
+            }
+
+            state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(labels.size()));
+        }
+
+        void shape_numeric_tick_labels(benchmark::State& state) { shape_tick_labels(state, ""); }
+        void shape_tick_labels_with_unit(benchmark::State& state) { shape_tick_labels(state, "s"); }
+
+        template <typename GetHeight>
+        void measure_glyph_heights(benchmark::State& state, const GetHeight& get_height)
+        {
+            const auto context = std::make_shared<font_context>(font_context_options{.shaped_text_cache_capacity = 0});
+            const auto shaper = text_shaper(context);
+            const auto label = long_label(state.range(0));
+            const auto shaped = shaper.shape(label, 12_pt, 100_dpi);
+            auto* face = shaped.runs().front().freetype_face;
+            freetype::set_size(face, 12_pt, 100_dpi);
+            for (auto _ : state)
+            {
+                FT_Pos height = 0;
+                for (const auto& glyph : shaped.runs().front().glyphs)
+                    height = std::max(height, get_height(face, static_cast<FT_UInt>(glyph.index)));
+
+                benchmark::DoNotOptimize(height);
+            }
+
+            state.SetItemsProcessed(state.iterations() * state.range(0));
+        }
+
+        // the way glyph heights were determined before the introduction of the glyph metrics table
+        void glyph_heights_from_outlines(benchmark::State& state)
+        {
+            measure_glyph_heights(state, [](FT_Face face, const FT_UInt index) {
+                FT_Load_Glyph(face, index, FT_LOAD_DEFAULT);
+                return face->glyph->metrics.height;
+            });
+        }
+
+        void glyph_heights_from_table(benchmark::State& state)
+        {
+            measure_glyph_heights(state, &freetype::glyph_height);
+        }
+    }
+
+    BENCHMARK(shape_long_label)->Arg(16)->Arg(256)->Arg(4096);
+    BENCHMARK(shape_numeric_tick_labels);
+    BENCHMARK(shape_tick_labels_with_unit);
+    BENCHMARK(glyph_heights_from_outlines)->Arg(16)->Arg(256)->Arg(4096);
+    BENCHMARK(glyph_heights_from_table)->Arg(16)->Arg(256)->Arg(4096);
+}
@@ -0,0 +1,115 @@
+#include <cdv/back_end/cairo.hpp>
+#include <cdv/elem/line.hpp>
+#include <cdv/elem/text.hpp>
+#include <cdv/fnt/font_context.hpp>
+#include <cdv/fig/frame.hpp>
+#include <cdv/fig/render_batch.hpp>
+#include <cdv/fig/render_svg.hpp>
+
+#include <doctest/doctest.h>
+
+#include <array>
+#include <memory>
+#include <tuple>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace cdv::back_end
+{
+    using namespace units_literals;
+
+    namespace
+    {
+        size_t count(const std::string& str, const std::string& pattern)
+        {
+            size_t result = 0;
+            for (auto pos = str.find(pattern); pos != std::string::npos; pos = str.find(pattern, pos + 1))
+                ++result;
+
+            return result;
+        }
+    }
+
+    TEST_SUITE("cairo back end")
+    {
+        TEST_CASE("surfaces on different threads")
+        {
+            constexpr auto frame = fig::frame();
+            const auto xs = std::array{frame.x0(), frame.x1()};
+            const auto ys = std::array{frame.y0(), frame.y1()};
+            const auto render = [&] {
+                const auto line = elem::line{.xs = xs, .ys = ys};
+                const auto text = elem::text{.string = "diagonal", .pos = {frame.x0(), frame.y1()}};
+                return fig::render_to_svg_string(frame.dimensions(), line, text);
+            };
+
+            const auto expected = render();
+
+            std::vector<std::string> results(4);
+            std::vector<std::thread> threads;
+            for (auto& result : results)
+                threads.emplace_back([&] {
+                    for (auto i = 0; i < 8; ++i)
+                        result = render();
+                });
+
+            for (auto& thread : threads)
+                thread.join();
+
+            for (const auto& result : results)
+                CHECK_EQ(result, expected);
+        }
+
+        TEST_CASE("font contexts that are destroyed")
+        {
+            // cairo's font caches hold on to the faces of every context after the context is gone
+            constexpr auto frame = fig::frame();
+            const auto text = elem::text{.string = "x = 1.5", .pos = {frame.x0(), frame.y1()}};
+            const auto figures = std::vector{std::tuple(text)};
+            const auto render = [&] {
+                const auto options =
+                    fig::batch_options{.num_threads = 1, .context = std::make_shared<fnt::font_context>()};
+                return fig::render_batch_to_svg_strings(frame.dimensions(), figures, options).front();
+            };
+
+            const auto expected = render();
+            for (auto i = 0; i < 8; ++i)
+                CHECK_EQ(render(), expected);
+        }
+
+        TEST_CASE("formula glyphs")
+        {
+            // Each run of formula glyphs with the same face and size is one show_glyphs call, which cairo writes as
+            // one group. The approved svgs of the log scales depend on this.
+            constexpr auto frame = fig::frame();
+            const auto label = elem::text{.string = "$10^{-12}$", .pos = frame.center()};
+            const auto str = fig::render_to_svg_string(frame.dimensions(), label);
+            CHECK_EQ(count(str, "<g style="), 2);
+            CHECK_EQ(count(str, "<use "), 5);
+        }
+
+        TEST_CASE("append_path")
+        {
+            const auto positions = std::vector<pixel_pos>{{10_px, 10_px}, {50_px, 80_px}, {90_px, 20_px}};
+            const auto draw = [&](const bool append_path) {
+                auto back_end = cairo(100_px, 100_px);
+                if (append_path)
+                    back_end.append_path(positions);
+                else
+                {
+                    back_end.move_to(positions.front());
+                    for (const auto& pos : std::span(positions).subspan(1))
+                        back_end.line_to(pos);
+                }
+
+                back_end.stroke();
+                const auto image = back_end.image();
+                return std::vector<unsigned char>(image.data, image.data + image.height * image.stride);
+            };
+
+            CHECK_EQ(draw(true), draw(false));
+        }
+    }
+}
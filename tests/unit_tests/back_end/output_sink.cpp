@@ -0,0 +1,106 @@
+#include <cdv/back_end/output_sink.hpp>
+#include <cdv/back_end/svg.hpp>
+#include <cdv/elem/line.hpp>
+#include <cdv/fig/frame.hpp>
+#include <cdv/fig/render_svg.hpp>
+
+#include <doctest/doctest.h>
+
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace cdv::back_end
+{
+    using namespace units_literals;
+
+    TEST_SUITE("output sink")
+    {
+        TEST_CASE("buffering")
+        {
+            std::ostringstream os;
+            auto sink = output_sink(os, 8);
+
+            CHECK(sink.write("abc", 3));
+            CHECK(sink.write("def", 3));
+            CHECK(os.str().empty());
+            CHECK_EQ(sink.bytes_written(), 0);
+
+            CHECK(sink.write("ghi", 3));  // doesn't fit into the buffer anymore
+            CHECK_EQ(os.str(), "abcdef");
+            CHECK_EQ(sink.num_flushes(), 1);
+
+            CHECK(sink.write("0123456789", 10));  // larger than the buffer
+            CHECK_EQ(os.str(), "abcdefghi0123456789");
+            CHECK_EQ(sink.num_flushes(), 3);
+
+            sink.write("xyz", 3);
+            sink.flush();
+            CHECK_EQ(os.str(), "abcdefghi0123456789xyz");
+            CHECK_EQ(sink.bytes_written(), 22);
+            CHECK_EQ(sink.num_flushes(), 4);
+            CHECK_FALSE(sink.failed());
+        }
+
+        TEST_CASE("write errors")
+        {
+            std::ostringstream os;
+            os.setstate(std::ios::badbit);
+            auto sink = output_sink(os, 8);
+
+            CHECK(sink.write("abc", 3));  // only buffered
+            CHECK_THROWS_AS(sink.flush(), std::runtime_error);
+            CHECK(sink.failed());
+            CHECK_FALSE(sink.write("abc", 3));
+        }
+
+        TEST_CASE("svg output")
+        {
+            constexpr auto frame = fig::frame();
+            const auto xs = std::array{frame.x0(), frame.x1()};
+            const auto ys = std::array{frame.y0(), frame.y1()};
+            const auto line = elem::line{.xs = xs, .ys = ys};
+
+            SUBCASE("errors are reported")
+            {
+                std::ostringstream os;
+                os.setstate(std::ios::badbit);
+                CHECK_THROWS_AS(fig::render_to_svg_stream(os, frame.dimensions(), line), std::runtime_error);
+                CHECK_THROWS_AS(fig::render_to_svg_stream<svg>(os, frame.dimensions(), line), std::runtime_error);
+            }
+
+            SUBCASE("file streams")
+            {
+                const auto file_name = (std::filesystem::temp_directory_path() / "cdv_output_sink_test.svg").string();
+                fig::render_svg(file_name, frame.dimensions(), line);
+
+                std::ifstream is(file_name);
+                const auto file_content = std::string(std::istreambuf_iterator<char>(is), {});
+                CHECK_EQ(file_content, fig::render_to_svg_string(frame.dimensions(), line));
+                std::filesystem::remove(file_name);
+            }
+
+            SUBCASE("reusing a sink")
+            {
+                std::ostringstream os;
+                auto sink = output_sink(os);
+                for (auto i = 0; i < 2; ++i)
+                {
+                    auto back_end = svg(frame.width, frame.height, sink);
+                    back_end.move_to({0_px, 0_px});
+                    back_end.line_to({10_px, 10_px});
+                    back_end.stroke();
+                    back_end.finish();
+                }
+
+                const auto str = os.str();
+                CHECK_EQ(str.size(), sink.bytes_written());
+                CHECK_EQ(str.substr(0, str.size() / 2), str.substr(str.size() / 2));
+            }
+        }
+    }
+}
@@ -0,0 +1,130 @@
+#include <cdv/back_end/cairo.hpp>
+#include <cdv/back_end/png_encoder.hpp>
+#include <cdv/elem/line.hpp>
+#include <cdv/elem/rectangle.hpp>
+#include <cdv/elem/text.hpp>
+#include <cdv/fig/frame.hpp>
+#include <cdv/fig/render_surface.hpp>
+
+#include <cairo.h>
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace cdv::back_end
+{
+    using namespace units_literals;
+
+    namespace
+    {
+        using surface_ptr = std::unique_ptr<cairo_surface_t, void (*)(cairo_surface_t*)>;
+
+        struct png_reader
+        {
+            const std::vector<unsigned char>& png;
+            size_t pos = 0;
+        };
+
+        surface_ptr decode_png(const std::vector<unsigned char>& png)
+        {
+            const auto callback = [](void* closure, unsigned char* data, unsigned int size) {
+                auto& reader = *static_cast<png_reader*>(closure);
+                if (reader.png.size() - reader.pos < size) return CAIRO_STATUS_READ_ERROR;
+                std::memcpy(data, reader.png.data() + reader.pos, size);
+                reader.pos += size;
+                return CAIRO_STATUS_SUCCESS;
+            };
+
+            auto reader = png_reader{.png = png};
+            auto result = surface_ptr(cairo_image_surface_create_from_png_stream(callback, &reader),
+                                      cairo_surface_destroy);
+            REQUIRE_EQ(cairo_surface_status(result.get()), CAIRO_STATUS_SUCCESS);
+            return result;
+        }
+
+        void check_pixels(const image_view& expected, cairo_surface_t* actual)
+        {
+            REQUIRE_EQ(cairo_image_surface_get_width(actual), expected.width);
+            REQUIRE_EQ(cairo_image_surface_get_height(actual), expected.height);
+
+            const auto* data = cairo_image_surface_get_data(actual);
+            const auto stride = cairo_image_surface_get_stride(actual);
+            const auto row_size = static_cast<size_t>(expected.width) * 4;
+            for (auto y = 0; y < expected.height; ++y)
+                REQUIRE(std::equal(expected.data + y * expected.stride, expected.data + y * expected.stride + row_size,
+                                   data + y * stride));
+        }
+    }
+
+    TEST_SUITE("png encoder")
+    {
+        constexpr auto frame = fig::frame();
+
+        constexpr auto extents = pixel_pos{frame.width, frame.height};
+
+        void draw_figure(fig::render_surface<cairo>& surface)
+        {
+            const auto half_transparent = rgba_color(0.2, 0.4, 0.8, 0.5);
+            const auto quadrant = elem::rectangle{
+                .min = frame.center(), .max = {frame.x1(), frame.y1()}, .fill = {.color = half_transparent}};
+            draw(quadrant, surface, extents);
+            draw(elem::hline(frame.x0(), frame.x1(), frame.y_center()), surface, extents);
+            draw(elem::text{.string = "png", .pos = frame.center()}, surface, extents);
+        }
+
+        TEST_CASE("round trip")
+        {
+            fig::render_surface<cairo> surface(cairo(extents.x, extents.y), frame.dpi);
+            draw_figure(surface);
+            const auto image = surface.image();
+
+            for (const auto filter : {png_filter::none, png_filter::sub, png_filter::up, png_filter::average,
+                                      png_filter::paeth, png_filter::adaptive})
+                for (const auto level : {0, 1, 6, 9})
+                {
+                    std::vector<unsigned char> png;
+                    encode_png(image, png, {.compression_level = level, .filter = filter});
+                    check_pixels(image, decode_png(png).get());
+                }
+        }
+
+        TEST_CASE("parallel deflate")
+        {
+            fig::render_surface<cairo> surface(cairo(extents.x, extents.y), frame.dpi);
+            draw_figure(surface);
+            const auto image = surface.image();
+
+            std::vector<unsigned char> single_threaded;
+            encode_png(image, single_threaded);
+
+            for (const auto chunk_size : {size_t(1), size_t(10000), size_t(100000)})
+            {
+                std::vector<unsigned char> png;
+                encode_png(image, png, {.num_threads = 4, .chunk_size = chunk_size});
+                check_pixels(image, decode_png(png).get());
+                if (chunk_size > 1) CHECK_LT(png.size(), single_threaded.size() * 11 / 10);
+            }
+        }
+
+        TEST_CASE("appends to the buffer")
+        {
+            fig::render_surface<cairo> surface(cairo(extents.x, extents.y), frame.dpi);
+            draw_figure(surface);
+            std::vector<unsigned char> png = {1, 2, 3};
+            encode_png(surface.image(), png);
+            REQUIRE_GT(png.size(), 11);
+            CHECK_EQ(png[0], 1);
+            CHECK_EQ(png[4], 'P');
+        }
+
+        TEST_CASE("empty image")
+        {
+            std::vector<unsigned char> png;
+            CHECK_THROWS_AS(encode_png(image_view{}, png), std::runtime_error);
+        }
+    }
+}
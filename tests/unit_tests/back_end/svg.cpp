@@ -0,0 +1,220 @@
+#include <cdv/back_end/svg.hpp>
+#include <cdv/elem/line.hpp>
+#include <cdv/elem/text.hpp>
+#include <cdv/fig/frame.hpp>
+#include <cdv/fig/render_svg.hpp>
+#include <cdv/stdx/numbers.hpp>
+
+#include <doctest/doctest.h>
+
+#include <array>
+#include <span>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace cdv::back_end
+{
+    using namespace units_literals;
+
+    namespace
+    {
+        size_t count(const std::string& str, const std::string& pattern)
+        {
+            size_t result = 0;
+            for (auto pos = str.find(pattern); pos != std::string::npos; pos = str.find(pattern, pos + 1))
+                ++result;
+
+            return result;
+        }
+    }
+
+    TEST_SUITE("svg back end")
+    {
+        TEST_CASE("document")
+        {
+            std::ostringstream os;
+            {
+                auto back_end = svg(200_px, 100_px, os);
+                back_end.set_color(1.0, 0.0, 0.0, 0.5);
+                back_end.move_to({0_px, 0_px});
+                back_end.line_to({150_px, 80_px});
+                back_end.stroke();
+            }
+
+            const auto str = os.str();
+            CHECK(str.starts_with("<?xml"));
+            CHECK_NE(str.find(R"(viewBox="0 0 200 100")"), std::string::npos);
+            CHECK_NE(str.find(R"(stroke="#ff0000" stroke-opacity="0.5")"), std::string::npos);
+            CHECK_NE(str.find(R"(d="M0 100L150 20")"), std::string::npos);  // y = 0 is at the bottom
+            CHECK(str.ends_with("</svg>\n"));
+        }
+
+        TEST_CASE("append_path")
+        {
+            const auto positions = std::vector<pixel_pos>{{10_px, 10_px}, {50_px, 80_px}, {90_px, 20_px}};
+            std::ostringstream os0;
+            std::ostringstream os1;
+            {
+                auto back_end0 = svg(100_px, 100_px, os0);
+                back_end0.append_path(positions);
+                back_end0.stroke();
+
+                auto back_end1 = svg(100_px, 100_px, os1);
+                back_end1.move_to(positions.front());
+                for (const auto& pos : std::span(positions).subspan(1))
+                    back_end1.line_to(pos);
+                back_end1.stroke();
+            }
+
+            CHECK_EQ(os0.str(), os1.str());
+            CHECK_NE(os0.str().find(R"(d="M10 90L50 20L90 80")"), std::string::npos);
+        }
+
+        TEST_CASE("clip rects")
+        {
+            std::ostringstream os;
+            auto back_end = svg(200_px, 100_px, os);
+            back_end.set_clip_rect({10_px, 10_px}, {100_px, 50_px});
+
+            const auto [min, max] = back_end.get_clip_rect();
+            CHECK_EQ(min.x.value(), doctest::Approx(10.0));
+            CHECK_EQ(min.y.value(), doctest::Approx(10.0));
+            CHECK_EQ(max.x.value(), doctest::Approx(110.0));
+            CHECK_EQ(max.y.value(), doctest::Approx(60.0));
+
+            // the clip rect is part of the state that is restored with the transformation
+            back_end.push_transformation({}, {}, {1.0, 1.0});
+            back_end.unset_clip_rect();
+            back_end.pop_transformation();
+            back_end.unset_clip_rect();
+            back_end.finish();
+
+            const auto str = os.str();
+            CHECK_EQ(count(str, "<clipPath"), 1);
+            CHECK_EQ(count(str, "<g clip-path"), 2);
+            CHECK_EQ(count(str, "<g"), count(str, "</g>"));
+        }
+
+        TEST_CASE("text")
+        {
+            constexpr auto frame = fig::frame();
+            const auto label = elem::text{.string = "abab", .pos = frame.center()};
+            const auto str = fig::render_to_svg_string<svg>(frame.dimensions(), label);
+
+            // every glyph is defined once and then referenced
+            CHECK_EQ(count(str, "<path id="), 2);
+            CHECK_EQ(count(str, "<use "), 4);
+        }
+
+        TEST_CASE("formula glyphs")
+        {
+            // the glyphs of a formula are drawn in one group for each run of glyphs with the same face and size
+            constexpr auto frame = fig::frame();
+            const auto label = elem::text{.string = "$10^{-12}$", .pos = frame.center()};
+            const auto str = fig::render_to_svg_string<svg>(frame.dimensions(), label);
+            CHECK_EQ(count(str, "<g"), 2);
+            CHECK_EQ(count(str, "<use "), 5);
+        }
+
+        TEST_CASE("same interface as cairo")
+        {
+            constexpr auto frame = fig::frame();
+            const auto xs = std::array{frame.x0(), frame.x1()};
+            const auto ys = std::array{frame.y0(), frame.y1()};
+            const auto line = elem::line{.xs = xs, .ys = ys, .properties = {.style = "--"}};
+            const auto text = elem::text{.string = "diagonal", .pos = {frame.x0(), frame.y1()}};
+
+            const auto str = fig::render_to_svg_string<svg>(frame.dimensions(), line, text);
+            CHECK_NE(str.find("stroke-dasharray"), std::string::npos);
+            CHECK_NE(str.find(R"(d="M40 450L620 30")"), std::string::npos);
+            CHECK(str.ends_with("</svg>\n"));
+        }
+
+        TEST_CASE("compact output")
+        {
+            const auto draw_lines = [](svg& back_end, const double opacity) {
+                back_end.set_color(0.0, 0.0, 0.0, opacity);
+                back_end.move_to({10_px, 10_px});
+                back_end.line_to({20_px, 10_px});
+                back_end.line_to({20.125_px, 30_px});
+                back_end.stroke();
+                back_end.move_to({50_px, 50_px});
+                back_end.line_to({60_px, 60_px});
+                back_end.stroke();
+            };
+
+            std::ostringstream os;
+            SUBCASE("path data")
+            {
+                {
+                    auto back_end = svg(200_px, 100_px, os, {.precision = 1, .relative_path_commands = true});
+                    draw_lines(back_end, 1.0);
+                }
+
+                const auto str = os.str();
+                CHECK_NE(str.find(R"(d="M10 90H20l.1-20")"), std::string::npos);
+                CHECK_EQ(count(str, "<path"), 2);
+            }
+
+            SUBCASE("shared styles and merged paths")
+            {
+                {
+                    auto back_end = svg(200_px, 100_px, os, svg_options::compact());
+                    draw_lines(back_end, 1.0);
+                    draw_lines(back_end, 0.5);
+                }
+
+                // overlapping transparent strokes would look different, so they are not merged
+                const auto str = os.str();
+                CHECK_EQ(count(str, "<style>"), 2);
+                CHECK_EQ(count(str, "<path"), 3);
+                CHECK_EQ(count(str, R"(class="s1")"), 2);
+            }
+
+            SUBCASE("overlapping fills")
+            {
+                {
+                    auto back_end = svg(200_px, 100_px, os, svg_options::compact());
+                    for (const auto x : {10_px, 30_px, 35_px})
+                    {
+                        back_end.arc({x, 50_px}, 5_px, radians(0.0), radians(2.0 * stdx::numbers::pi));
+                        back_end.fill();
+                    }
+                }
+
+                const auto str = os.str();
+                CHECK_EQ(count(str, "<path"), 2);
+                CHECK_EQ(count(str, "M"), 3);
+            }
+
+            SUBCASE("svgz")
+            {
+                {
+                    auto back_end = svg(200_px, 100_px, os, {.gzip = true});
+                    draw_lines(back_end, 1.0);
+                }
+
+                const auto str = os.str();
+                REQUIRE_GE(str.size(), 2);
+                CHECK_EQ(static_cast<unsigned char>(str[0]), 0x1f);
+                CHECK_EQ(static_cast<unsigned char>(str[1]), 0x8b);
+            }
+        }
+
+        TEST_CASE("compact figures")
+        {
+            constexpr auto frame = fig::frame();
+            const auto xs = std::array{frame.x0(), frame.x0() + 0.3_px, frame.x1()};
+            const auto ys = std::array{frame.y0(), frame.y1(), frame.y1() - 0.7_px};
+            const auto line = elem::line{.xs = xs, .ys = ys};
+            const auto text = elem::text{.string = "compact", .pos = frame.center()};
+
+            const auto str = fig::render_to_svg_string<svg>(frame.dimensions(), line, text);
+            const auto compact_str = fig::render_to_svg_string(svg_options::compact(), frame.dimensions(), line, text);
+            CHECK_LT(compact_str.size(), str.size());
+            CHECK_EQ(count(compact_str, "<use "), count(str, "<use "));
+            CHECK(compact_str.ends_with("</svg>\n"));
+        }
+    }
+}
@@ -59,5 +59,19 @@ namespace cdv::elem
             CHECK_EQ(result.fill_counter(), 1);
             CHECK_EQ(result.stroke_counter(), 1);
         }
+
+        TEST_CASE("simplified fill between")
+        {
+            auto statistics = simplification_statistics();
+            const auto a = fill_between(std::array{1_px, 2_px, 3_px}, std::array{4_px, 4_px, 4_px}, 0_px,
+                                        {.outline = {.width = 2_pt}}, {.tolerance = 0.1_px, .statistics = &statistics});
+            auto result = test::mock_surface();
+            draw(a, result, {});
+            CHECK_EQ(result.fill_counter(), 1);
+            CHECK_EQ(result.stroke_counter(), 1);
+            CHECK_EQ(statistics.num_paths, 1);
+            CHECK_EQ(statistics.num_vertices_before, 5);
+            CHECK_EQ(statistics.num_vertices_after, 4);
+        }
     }
 }
\ No newline at end of file
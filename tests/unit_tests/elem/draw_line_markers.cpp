@@ -36,6 +36,12 @@ namespace cdv::elem::detail
             void set_line_properties(const line_properties&) {}
             void line_to(const pixel_pos pos) { positions.emplace_back(pos); }
 
+            void append_path(const std::span<const pixel_pos> path)
+            {
+                move_to(path.front());
+                positions.insert(positions.end(), path.begin() + 1, path.end());
+            }
+
             void stroke() { add_polyline(); }
 
 
@@ -4,6 +4,8 @@
 
 #include <doctest/doctest.h>
 
+#include <vector>
+
 namespace cdv::elem
 {
     using namespace units_literals;
@@ -56,5 +58,82 @@ namespace cdv::elem
             draw(l, result, {});
             CHECK_EQ(result.draw_path_counter(), 1);
         }
+
+        TEST_CASE("m4 decimation")
+        {
+            // three quarter pixel columns, only the first and last point of a constant run are kept
+            const auto positions =
+                std::vector{pixel_pos(0_px, 5_px),    pixel_pos(0.1_px, 1_px), pixel_pos(0.2_px, 9_px),
+                            pixel_pos(0.24_px, 4_px), pixel_pos(1_px, 3_px),   pixel_pos(2_px, 1_px),
+                            pixel_pos(2.1_px, 1_px),  pixel_pos(2.2_px, 1_px)};
+            CHECK_EQ(detail::m4_decimate(positions),
+                     std::vector{pixel_pos(0_px, 5_px), pixel_pos(0.1_px, 1_px), pixel_pos(0.2_px, 9_px),
+                                 pixel_pos(0.24_px, 4_px), pixel_pos(1_px, 3_px), pixel_pos(2_px, 1_px),
+                                 pixel_pos(2.2_px, 1_px)});
+
+            // the order of the lowest and highest point is kept
+            const auto zigzag = std::vector{pixel_pos(5_px, 2_px), pixel_pos(5.1_px, 9_px), pixel_pos(5.15_px, 0_px),
+                                            pixel_pos(5.2_px, 3_px), pixel_pos(5.22_px, 4_px)};
+            CHECK_EQ(detail::m4_decimate(zigzag), std::vector{pixel_pos(5_px, 2_px), pixel_pos(5.1_px, 9_px),
+                                                              pixel_pos(5.15_px, 0_px), pixel_pos(5.22_px, 4_px)});
+
+            CHECK(detail::m4_decimate(std::vector<pixel_pos>{}).empty());
+        }
+
+        TEST_CASE("draw decimated")
+        {
+            const auto l = line(std::vector{1_px, 2_px, 3_px}, std::vector{4_px, 5_px, 6_px}, {}, line_decimation::m4);
+            auto result = test::mock_surface();
+            draw(l, result, {});
+            CHECK_EQ(result.draw_path_counter(), 1);
+            CHECK_EQ(result.stroke_counter(), 1);
+        }
+
+        TEST_CASE("simplify polyline")
+        {
+            const auto positions = std::vector{pixel_pos(0_px, 0_px), pixel_pos(1_px, 0.1_px), pixel_pos(2_px, 0_px),
+                                               pixel_pos(3_px, 5_px), pixel_pos(4_px, 0_px)};
+            CHECK_EQ(detail::simplify_polyline(positions, 0.5_px),
+                     std::vector{pixel_pos(0_px, 0_px), pixel_pos(2_px, 0_px), pixel_pos(3_px, 5_px),
+                                 pixel_pos(4_px, 0_px)});
+            CHECK_EQ(detail::simplify_polyline(positions, 0.05_px), positions);
+
+            // a path that turns back is measured against the segment and not against the whole line through it
+            const auto back_and_forth = std::vector{pixel_pos(0_px, 0_px), pixel_pos(10_px, 0_px),
+                                                    pixel_pos(5_px, 0.2_px), pixel_pos(0_px, 0_px)};
+            CHECK_EQ(detail::simplify_polyline(back_and_forth, 1_px),
+                     std::vector{pixel_pos(0_px, 0_px), pixel_pos(10_px, 0_px), pixel_pos(0_px, 0_px)});
+        }
+
+        TEST_CASE("simplification statistics")
+        {
+            auto statistics = simplification_statistics();
+            const auto l = line(std::vector{1_px, 2_px, 3_px, 4_px}, std::vector{4_px, 4_px, 4_px, 4_px}, {}, {},
+                                {.tolerance = 0.1_px, .statistics = &statistics});
+            auto result = test::mock_surface();
+            draw(l, result, {});
+            draw(l, result, {});
+            CHECK_EQ(result.draw_path_counter(), 2);
+            CHECK_EQ(statistics.num_paths, 2);
+            CHECK_EQ(statistics.num_vertices_before, 8);
+            CHECK_EQ(statistics.num_vertices_after, 4);
+        }
+
+        TEST_CASE("segments outside of the clip rect are left out")
+        {
+            const auto xs = std::vector{10_px, 500_px, 1000_px, 500_px, 10_px};
+            const auto ys = std::vector{50_px, 50_px, 50_px, 50_px, 50_px};
+            auto result = test::mock_surface();
+            result.set_clip_rect({0_px, 0_px}, {100_px, 100_px});
+
+            // the path leaves the clip rect and comes back, which makes two sub-paths
+            draw(line{.xs = xs, .ys = ys}, result, {});
+            CHECK_EQ(result.draw_path_counter(), 2);
+            CHECK_EQ(result.stroke_counter(), 1);
+
+            // dashes would restart in every sub-path
+            draw(line{.xs = xs, .ys = ys, .properties = {.style = "--"}}, result, {});
+            CHECK_EQ(result.draw_path_counter(), 3);
+        }
     }
-}
\ No newline at end of file
+}
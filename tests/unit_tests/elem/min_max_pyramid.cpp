@@ -0,0 +1,169 @@
+#include <cdv/elem/detail/m4_decimation.hpp>
+#include <cdv/elem/min_max_pyramid.hpp>
+#include <cdv/scl/linear_scale.hpp>
+#include <cdv/scl/time_scale.hpp>
+#include <cdv/stdx/date.hpp>
+
+#include <doctest/doctest.h>
+
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace cdv::elem
+{
+    using namespace units_literals;
+    using namespace std::literals::chrono_literals;
+
+    namespace
+    {
+        const auto d0 = std::chrono::sys_seconds(date::sys_days(date::year(2024) / 1 / 1));
+
+        // one sample per second
+        std::pair<std::vector<std::chrono::sys_seconds>, std::vector<double>> sine_samples()
+        {
+            std::vector<std::chrono::sys_seconds> xs;
+            std::vector<double> ys;
+            for (auto i = 0; i < 100'000; ++i)
+            {
+                xs.push_back(d0 + i * 1s);
+                ys.push_back(std::sin(0.01 * i));
+            }
+
+            return {std::move(xs), std::move(ys)};
+        }
+
+        // the line has to consist of the positions that m4_decimate keeps of the samples [first, last]
+        template <typename Line, typename XScale, typename YScale>
+        void check_decimated(const Line& l, const std::vector<std::chrono::sys_seconds>& xs,
+                             const std::vector<double>& ys, const size_t first, const size_t last,
+                             const XScale& x, const YScale& y)
+        {
+            std::vector<pixel_pos> positions;
+            for (auto i = first; i <= last; ++i)
+                positions.emplace_back(x(xs[i]), y(ys[i]));
+
+            const auto expected = detail::m4_decimate(positions);
+            REQUIRE_EQ(l.xs.size(), expected.size());
+            REQUIRE_EQ(l.ys.size(), expected.size());
+            for (size_t i = 0; i < expected.size(); ++i)
+            {
+                CHECK_EQ(l.xs[i], expected[i].x);
+                CHECK_EQ(l.ys[i], expected[i].y);
+            }
+        }
+    }
+
+    TEST_SUITE("min max pyramid")
+    {
+        TEST_CASE("lowest and highest sample of an index range")
+        {
+            auto generator = std::mt19937(42);
+            auto distribution = std::uniform_int_distribution(0, 20);
+            for (const size_t n : {1, 2, 3, 7, 64, 100, 1000})
+            {
+                std::vector<double> xs(n);
+                std::vector<double> ys(n);
+                for (size_t i = 0; i < n; ++i)
+                {
+                    xs[i] = double(i);
+                    ys[i] = distribution(generator);
+                }
+
+                const auto pyramid = min_max_pyramid(xs, ys);
+                for (size_t first = 0; first < n; first += 3)
+                {
+                    for (auto last = first + 1; last <= n; last += 5)
+                    {
+                        auto lowest = first;
+                        auto highest = first;
+                        for (auto i = first; i < last; ++i)
+                        {
+                            if (ys[i] < ys[lowest]) lowest = i;
+                            if (ys[i] > ys[highest]) highest = i;
+                        }
+
+                        const auto [min, max] = pyramid.min_max_indices(first, last);
+                        CHECK_EQ(min, lowest);
+                        CHECK_EQ(max, highest);
+                    }
+                }
+            }
+        }
+
+        TEST_CASE("select")
+        {
+            const auto xs = std::vector{0.0, 1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0};
+            const auto ys = std::vector{5.0, 3.0, 8.0, 1.0, 4.0, 4.0, 4.0, 4.0, 2.0, 6.0};
+            const auto pyramid = min_max_pyramid(xs, ys);
+            const auto column_of = [](const double x) { return std::floor(x / 5.0); };
+
+            // first, highest, lowest and last sample of both columns
+            CHECK_EQ(pyramid.select(0.0, 9.0, column_of), std::vector<size_t>{0, 2, 3, 4, 5, 8, 9});
+
+            // the sample before 6 is included, the range ends at the last sample
+            CHECK_EQ(pyramid.select(6.0, 20.0, column_of), std::vector<size_t>{5, 8, 9});
+
+            CHECK_EQ(pyramid.select(20.0, 30.0, column_of), std::vector<size_t>{9});
+        }
+
+        TEST_CASE("make line")
+        {
+            const auto [xs, ys] = sine_samples();
+            const auto pyramid = min_max_pyramid(xs, ys);
+            const auto x = scl::time_scale(d0 + 1000s, d0 + 11'000s, 0_px, 100_px);
+            const auto y = scl::linear_scale(-1.0, 1.0, 0_px, 50_px);
+            const auto l = pyramid.make_line(d0 + 1000s, d0 + 11'000s, x, y, {.width = 2_pt});
+
+            // the same as decimating all the samples in the range and the closest one on either side
+            check_decimated(l, xs, ys, 999, 11'001, x, y);
+
+            // at most four samples for each of the 400 quarter pixel columns and the two outside of the range
+            CHECK_LE(l.xs.size(), 4 * 402);
+            CHECK_EQ(l.xs.front(), x(d0 + 999s));
+            CHECK_EQ(l.xs.back(), x(d0 + 11'001s));
+            CHECK_EQ(l.properties.width, 2_pt);
+        }
+
+        TEST_CASE("make line at the end of the samples")
+        {
+            const auto [xs, ys] = sine_samples();
+            const auto pyramid = min_max_pyramid(xs, ys);
+            const auto x = scl::time_scale(d0 + 95'000s, d0 + 105'000s, 0_px, 300_px);
+            const auto y = scl::linear_scale(-1.0, 1.0, 0_px, 50_px);
+            const auto l = pyramid.make_line(d0 + 95'000s, d0 + 105'000s, x, y);
+            check_decimated(l, xs, ys, 94'999, xs.size() - 1, x, y);
+        }
+
+        TEST_CASE("make line with a reversed x scale")
+        {
+            const auto [xs, ys] = sine_samples();
+            const auto pyramid = min_max_pyramid(xs, ys);
+            const auto x = scl::time_scale(d0 + 1000s, d0 + 11'000s, 100_px, 0_px);
+            const auto y = scl::linear_scale(-1.0, 1.0, 0_px, 50_px);
+            const auto l = pyramid.make_line(d0 + 1000s, d0 + 11'000s, x, y);
+
+            // the columns are counted from the right, as if the line was drawn mirrored
+            const auto mirrored_x = [&](const std::chrono::sys_seconds t) { return -x(t); };
+            auto mirrored = l;
+            for (auto& px : mirrored.xs)
+                px = -px;
+
+            check_decimated(mirrored, xs, ys, 999, 11'001, mirrored_x, y);
+            CHECK_EQ(l.xs.front(), x(d0 + 999s));
+        }
+
+        TEST_CASE("invalid samples")
+        {
+            const auto pyramid = min_max_pyramid(std::vector{0.0, 1.0}, std::vector{0.0, 1.0});
+            CHECK_THROWS_AS(static_cast<void>(pyramid.min_max_indices(1, 1)), std::invalid_argument);
+            CHECK_THROWS_AS(static_cast<void>(pyramid.min_max_indices(0, 3)), std::invalid_argument);
+
+            CHECK_THROWS_AS(min_max_pyramid(std::vector{0.0, 1.0}, std::vector{0.0}), std::runtime_error);
+            CHECK_THROWS_AS(min_max_pyramid(std::vector{1.0, 0.0}, std::vector{0.0, 0.0}), std::runtime_error);
+        }
+    }
+}
@@ -25,5 +25,36 @@ namespace cdv::elem
             draw(r, result, {});
             CHECK_EQ(result.draw_path_counter(), 2);
         }
+
+        TEST_CASE("rectangles outside of the clip rect are not drawn")
+        {
+            auto result = test::mock_surface();
+            result.set_clip_rect({0_px, 0_px}, {100_px, 100_px});
+            draw(rectangle{.min = {150_px, 20_px}, .max = {200_px, 50_px}}, result, {});
+            CHECK_EQ(result.draw_path_counter(), 0);
+
+            draw(rectangle{.min = {-50_px, 20_px}, .max = {200_px, 50_px}}, result, {});
+            CHECK_EQ(result.draw_path_counter(), 1);
+        }
+
+        TEST_CASE("rectangles just inside and just outside of the stroke margin")
+        {
+            // the clip rect goes from (100, 100) to (200, 150)
+            auto result = test::mock_surface();
+            result.set_clip_rect({100_px, 100_px}, {100_px, 50_px});
+
+            // without an outline the margin is 1px
+            draw(rectangle{.min = {200.9_px, 120_px}, .max = {250_px, 130_px}}, result, {});
+            CHECK_EQ(result.draw_path_counter(), 1);
+            draw(rectangle{.min = {201.1_px, 120_px}, .max = {250_px, 130_px}}, result, {});
+            CHECK_EQ(result.draw_path_counter(), 1);
+
+            // a 2pt outline with miter joins reaches up to 13.89px + 1px out at 100 dpi
+            const auto outline = fill_properties{.outline = {.width = 2_pt}};
+            draw(rectangle{.min = {120_px, 50_px}, .max = {130_px, 85.2_px}, .fill = outline}, result, {});
+            CHECK_EQ(result.draw_path_counter(), 3);
+            draw(rectangle{.min = {120_px, 50_px}, .max = {130_px, 85_px}, .fill = outline}, result, {});
+            CHECK_EQ(result.draw_path_counter(), 3);
+        }
     }
 }
\ No newline at end of file
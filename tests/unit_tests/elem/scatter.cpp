@@ -41,5 +41,27 @@ namespace cdv::elem
             CHECK_EQ(result.draw_arc_counter(), 0);
             CHECK_EQ(result.draw_path_counter(), 3);  // the outline of each star is a single path
         }
+
+        TEST_CASE("markers outside of the clip rect are not drawn")
+        {
+            const auto s = scatter{.xs = std::array{10_px, 50_px, 90_px, 500_px},
+                                   .ys = std::array{50_px, 50_px, 50_px, 50_px}};
+            auto result = test::mock_surface();
+            result.set_clip_rect({0_px, 0_px}, {100_px, 100_px});
+            draw(s, result, {});
+            CHECK_EQ(result.draw_arc_counter(), 3);
+        }
+
+        TEST_CASE("markers just inside and just outside of the stroke margin")
+        {
+            // A 6pt marker with a 1pt outline reaches 8.33px + 7.94px from its center at 100 dpi. The clip rect
+            // goes from (100, 100) to (200, 150).
+            const auto s = scatter{.xs = std::array{83.6_px, 83.8_px, 216.2_px, 216.4_px, 150_px, 150_px},
+                                   .ys = std::array{125_px, 125_px, 125_px, 125_px, 166.2_px, 166.4_px}};
+            auto result = test::mock_surface();
+            result.set_clip_rect({100_px, 100_px}, {100_px, 50_px});
+            draw(s, result, {});
+            CHECK_EQ(result.draw_arc_counter(), 3);
+        }
     }
 }
\ No newline at end of file
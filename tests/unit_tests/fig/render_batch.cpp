@@ -0,0 +1,92 @@
+#include <cdv/elem/line.hpp>
+#include <cdv/elem/text.hpp>
+#include <cdv/fig/frame.hpp>
+#include <cdv/fig/render_batch.hpp>
+#include <cdv/fig/render_png.hpp>
+#include <cdv/fig/render_svg.hpp>
+
+#include <doctest/doctest.h>
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace cdv::fig
+{
+    using namespace ::cdv::units_literals;
+
+    namespace
+    {
+        struct failing_element
+        {
+        };
+
+        template <typename Surface>
+        void draw(const failing_element&, Surface&, const pixel_pos&)
+        {
+            throw std::runtime_error("failed to draw");
+        }
+    }
+
+    TEST_SUITE("render batch")
+    {
+        constexpr auto frame = fig::frame();
+
+        auto figure(const int i)
+        {
+            const auto y = frame.y0() + pixels(10.0 * i);
+            return std::tuple{elem::hline(frame.x0(), frame.x1(), y),
+                              elem::text{.string = std::to_string(i), .pos = {frame.x_center(), y}}};
+        }
+
+        TEST_CASE("svg results match individually rendered figures")
+        {
+            std::vector<decltype(figure(0))> figures;
+            for (auto i = 0; i < 16; ++i)
+                figures.push_back(figure(i));
+
+            const auto svgs = render_batch_to_svg_strings(frame.dimensions(), figures, {.num_threads = 4});
+            REQUIRE_EQ(svgs.size(), figures.size());
+            for (auto i = 0u; i < figures.size(); ++i)
+                CHECK_EQ(svgs[i], render_to_svg_string(frame.dimensions(), figures[i]));
+        }
+
+        TEST_CASE("workers with their own font contexts")
+        {
+            std::vector<decltype(figure(0))> figures;
+            for (auto i = 0; i < 16; ++i)
+                figures.push_back(figure(i));
+
+            auto num_contexts = std::atomic<int>(0);
+            const auto options = batch_options{.num_threads = 4, .context_factory = [&] {
+                                                   ++num_contexts;
+                                                   return std::make_shared<fnt::font_context>();
+                                               }};
+            const auto svgs = render_batch_to_svg_strings(frame.dimensions(), figures, options);
+            CHECK_GE(num_contexts, 1);
+            CHECK_LE(num_contexts, 4);
+            REQUIRE_EQ(svgs.size(), figures.size());
+            for (auto i = 0u; i < figures.size(); ++i)
+                CHECK_EQ(svgs[i], render_to_svg_string(frame.dimensions(), figures[i]));
+        }
+
+        TEST_CASE("png results match individually rendered figures")
+        {
+            const auto figures = std::vector{figure(0), figure(1)};
+            const auto pngs = render_batch_to_png_buffers(frame.dimensions(), figures, {.num_threads = 2});
+            REQUIRE_EQ(pngs.size(), figures.size());
+            for (auto i = 0u; i < figures.size(); ++i)
+                CHECK_EQ(pngs[i], render_to_png_buffer(frame.dimensions(), figures[i]));
+        }
+
+        TEST_CASE("exceptions are passed on to the caller")
+        {
+            const auto figures = std::vector<failing_element>(8);
+            CHECK_THROWS_AS(render_batch_to_svg_strings(frame.dimensions(), figures, {.num_threads = 4}),
+                            std::runtime_error);
+        }
+    }
+}
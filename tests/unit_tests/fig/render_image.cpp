@@ -0,0 +1,56 @@
+#include <cdv/elem/line.hpp>
+#include <cdv/elem/text.hpp>
+#include <cdv/fig/frame.hpp>
+#include <cdv/fig/render_image.hpp>
+
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace cdv::fig
+{
+    TEST_SUITE("render image")
+    {
+        constexpr auto frame = fig::frame();
+        const auto line = elem::hline(frame.x0(), frame.x1(), frame.y_center());
+        const auto label = elem::text{.string = "pixels", .pos = frame.center()};
+
+        TEST_CASE("caller provided buffer")
+        {
+            const auto dimensions = frame.dimensions();
+            const auto stride = image_stride(dimensions);
+            REQUIRE_GE(stride, 4 * static_cast<int>(dimensions.width.value()));
+
+            std::vector<unsigned char> buffer(static_cast<size_t>(dimensions.height.value()) * stride, 0xff);
+            const auto image = render_to_image_buffer(buffer.data(), stride, dimensions, line, label);
+            CHECK_EQ(image.data, buffer.data());
+            CHECK_EQ(image.width, static_cast<int>(dimensions.width.value()));
+            CHECK_EQ(image.height, static_cast<int>(dimensions.height.value()));
+            CHECK_EQ(image.stride, stride);
+
+            const auto extents = pixel_pos{dimensions.width, dimensions.height};
+            render_surface<back_end::cairo> surface(back_end::cairo(extents.x, extents.y), dimensions.dpi);
+            draw(line, surface, extents);
+            draw(label, surface, extents);
+            const auto expected = surface.image();
+            REQUIRE_EQ(expected.stride, stride);
+            CHECK(std::equal(buffer.begin(), buffer.end(), expected.data));
+        }
+
+        TEST_CASE("invalid stride")
+        {
+            std::vector<unsigned char> buffer(16);
+            CHECK_THROWS_AS(back_end::cairo(pixels(100), pixels(1), buffer.data(), 3), std::runtime_error);
+        }
+
+        TEST_CASE("svg surfaces have no pixels")
+        {
+            std::ostringstream os;
+            const auto surface = back_end::cairo(pixels(100), pixels(100), os);
+            CHECK_THROWS_AS(static_cast<void>(surface.image()), std::runtime_error);
+        }
+    }
+}
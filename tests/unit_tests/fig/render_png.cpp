@@ -0,0 +1,37 @@
+#include <cdv/elem/line.hpp>
+#include <cdv/elem/text.hpp>
+#include <cdv/fig/frame.hpp>
+#include <cdv/fig/render_png.hpp>
+
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace cdv::fig
+{
+    TEST_SUITE("render png")
+    {
+        constexpr auto frame = fig::frame();
+        const auto line = elem::hline(frame.x0(), frame.x1(), frame.y_center());
+        const auto label = elem::text{.string = "png", .pos = frame.center()};
+
+        TEST_CASE("buffer")
+        {
+            const auto png = render_to_png_buffer(frame.dimensions(), line, label);
+            REQUIRE_GT(png.size(), 8);
+            const auto signature = std::vector<unsigned char>{0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+            CHECK(std::equal(signature.begin(), signature.end(), png.begin()));
+        }
+
+        TEST_CASE("stream and buffer output are identical")
+        {
+            std::ostringstream os;
+            render_to_png_stream(os, frame.dimensions(), line, label);
+            const auto png = render_to_png_buffer(frame.dimensions(), line, label);
+            CHECK_EQ(os.str(), std::string(png.begin(), png.end()));
+        }
+    }
+}
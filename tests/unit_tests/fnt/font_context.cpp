@@ -0,0 +1,79 @@
+#include <cdv/fnt/font_context.hpp>
+#include <cdv/fnt/text_shaper.hpp>
+
+#include <doctest/doctest.h>
+
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace cdv::fnt
+{
+    using namespace units_literals;
+
+    TEST_SUITE("font context")
+    {
+        TEST_CASE("default text shapers share the process wide context")
+        {
+            const auto s0 = text_shaper();
+            const auto s1 = text_shaper();
+            CHECK_EQ(s0.context(), font_context::shared());
+            CHECK_EQ(s0.context(), s1.context());
+        }
+
+        TEST_CASE("text shapers with a dedicated context")
+        {
+            const auto context = std::make_shared<font_context>();
+            const auto s0 = text_shaper(context);
+            const auto s1 = text_shaper(context);
+            CHECK_EQ(s0.context(), context);
+            CHECK_EQ(s0.shape("shape me", 12_pt, 100_dpi).extents(), s1.shape("shape me", 12_pt, 100_dpi).extents());
+        }
+
+        TEST_CASE("bundled fonts only")
+        {
+            const auto cache_directory = std::filesystem::temp_directory_path() / "cdv_font_context_test_cache";
+            const auto options = font_context_options{.bundled_fonts_only = true, .font_cache_directory = cache_directory};
+            for (auto i = 0; i < 2; ++i)  // the second context reads the cache written by the first
+            {
+                auto s = text_shaper(std::make_shared<font_context>(options));
+                CHECK_EQ(std::string(s.shape("a", 12_pt, 100_dpi).runs()[0].freetype_face->family_name),
+                         "DejaVu Sans");
+
+                s.select_face({.family = "monospace"}, 12_pt);
+                CHECK_EQ(std::string(s.shape("a", 12_pt, 100_dpi).runs()[0].freetype_face->family_name),
+                         "DejaVu Sans Mono");
+            }
+
+            CHECK_FALSE(std::filesystem::is_empty(cache_directory));
+            std::filesystem::remove_all(cache_directory);
+        }
+
+        TEST_CASE("text shapers on different threads")
+        {
+            const auto context = std::make_shared<font_context>();
+            const auto expected = text_shaper(context).shape("shape me", 12_pt, 100_dpi).extents();
+
+            std::vector<pixel_pos> results(4);
+            std::vector<std::thread> threads;
+            for (auto& result : results)
+            {
+                threads.emplace_back([&context, &result] {
+                    auto s = text_shaper(context);
+                    for (auto i = 0; i < 20; ++i)
+                    {
+                        s.select_face({.family = (i % 2 == 0) ? "times" : "sans-serif"}, 12_pt);
+                        result = s.shape("shape me", 12_pt, 100_dpi).extents();
+                    }
+                });
+            }
+
+            for (auto& t : threads)
+                t.join();
+
+            for (const auto& result : results)
+                CHECK_EQ(result, expected);
+        }
+    }
+}
@@ -1,16 +1,76 @@
+#include <cdv/fnt/freetype.hpp>
 #include <fnt/freetype_error.hpp>
 
 #include <doctest/doctest.h>
 #include <ft2build.h>
 #include FT_FREETYPE_H
+#include <harfbuzz/hb.h>
 
 namespace cdv::fnt
 {
+    using namespace units_literals;
+
     TEST_SUITE("freetype")
     {
         TEST_CASE("error reporting")
         {
             CHECK_EQ(ft_error_string(FT_Err_Bad_Argument), "FreeType Error: bad argument");
         }
+
+        TEST_CASE("faces are loaded once per path and index")
+        {
+            const auto ft = freetype();
+            const auto path = std::filesystem::path(CDV_DATA_DIR) / "fonts" / "ttf" / "DejaVuSans.ttf";
+            auto* face = &ft.face(path, 0);
+            CHECK_EQ(&ft.face(path, 0), face);
+            CHECK_NE(&ft.face(path.parent_path() / "DejaVuSans-Bold.ttf", 0), face);
+            CHECK_EQ(std::string(face->family_name), "DejaVu Sans");
+        }
+
+        TEST_CASE("harfbuzz fonts are reused and follow size changes")
+        {
+            const auto ft = freetype();
+            auto* face = &ft.face(mfl::font_family::italic);
+            freetype::set_size(face, 12_pt, 100_dpi);
+            auto* font = freetype::hb_font(face);
+            CHECK_EQ(freetype::hb_font(face), font);
+
+            int x_scale0 = 0;
+            int y_scale0 = 0;
+            hb_font_get_scale(font, &x_scale0, &y_scale0);
+
+            freetype::set_size(face, 24_pt, 100_dpi);
+            CHECK_EQ(freetype::hb_font(face), font);
+
+            int x_scale1 = 0;
+            int y_scale1 = 0;
+            hb_font_get_scale(font, &x_scale1, &y_scale1);
+            CHECK_GT(y_scale1, y_scale0);
+        }
+
+        TEST_CASE("setting the same size twice leaves the face untouched")
+        {
+            const auto ft = freetype();
+            auto* face = &ft.face(mfl::font_family::bold);
+            freetype::set_size(face, 12_pt, 100_dpi);
+            const auto metrics = face->size->metrics;
+            freetype::set_size(face, 12_pt, 100_dpi);
+            CHECK_EQ(face->size->metrics.y_scale, metrics.y_scale);
+            CHECK_EQ(face->size->metrics.y_ppem, metrics.y_ppem);
+        }
+
+        TEST_CASE("glyph heights match the glyph metrics")
+        {
+            const auto ft = freetype();
+            auto* face = &ft.face(mfl::font_family::italic);
+            freetype::set_size(face, 12_pt, 100_dpi);
+            for (const FT_UInt glyph_index : {1U, 20U, 40U})
+            {
+                const auto height = freetype::glyph_height(face, glyph_index);
+                CHECK_EQ(freetype::glyph_height(face, glyph_index), height);
+                FT_Load_Glyph(face, glyph_index, FT_LOAD_DEFAULT);
+                CHECK_EQ(height, face->glyph->metrics.height);
+            }
+        }
     }
-}
\ No newline at end of file
+}
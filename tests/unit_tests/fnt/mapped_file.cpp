@@ -0,0 +1,27 @@
+#include <fnt/mapped_file.hpp>
+
+#include <doctest/doctest.h>
+
+#include <cstring>
+#include <stdexcept>
+
+namespace cdv::fnt
+{
+    TEST_SUITE("mapped file")
+    {
+        TEST_CASE("font files are mapped once")
+        {
+            const auto path = std::filesystem::path(CDV_DATA_DIR) / "fonts" / "ttf" / "DejaVuSansMono.ttf";
+            const auto file0 = mapped_file::open(path);
+            const auto file1 = mapped_file::open(path);
+            CHECK_EQ(file0, file1);
+            CHECK_EQ(file0->size(), std::filesystem::file_size(path));
+            CHECK_EQ(std::memcmp(file0->data(), "\0\1\0\0", 4), 0);
+        }
+
+        TEST_CASE("missing files")
+        {
+            CHECK_THROWS_AS((void)mapped_file::open("does/not/exist.ttf"), std::runtime_error);
+        }
+    }
+}
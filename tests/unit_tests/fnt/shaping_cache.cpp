@@ -0,0 +1,91 @@
+#include <cdv/fnt/shaping_cache.hpp>
+
+#include <doctest/doctest.h>
+
+namespace cdv::fnt
+{
+    using namespace units_literals;
+
+    TEST_SUITE("shaping cache")
+    {
+        TEST_CASE("find text")
+        {
+            auto cache = shaping_cache(4);
+            CHECK_EQ(cache.find_text("a", nullptr, 12_pt, 100_dpi), nullptr);
+            cache.insert_text("a", nullptr, 12_pt, 100_dpi, shaped_text());
+            CHECK_NE(cache.find_text("a", nullptr, 12_pt, 100_dpi), nullptr);
+            CHECK_EQ(cache.find_text("a", nullptr, 10_pt, 100_dpi), nullptr);
+            CHECK_EQ(cache.find_text("a", nullptr, 12_pt, 72_dpi), nullptr);
+            CHECK_EQ(cache.find_text("b", nullptr, 12_pt, 100_dpi), nullptr);
+            CHECK_EQ(cache.text_statistics().hits, 1);
+            CHECK_EQ(cache.text_statistics().misses, 4);
+        }
+
+        TEST_CASE("least recently used text is evicted")
+        {
+            auto cache = shaping_cache(2);
+            cache.insert_text("a", nullptr, 12_pt, 100_dpi, shaped_text());
+            cache.insert_text("b", nullptr, 12_pt, 100_dpi, shaped_text());
+            CHECK_NE(cache.find_text("a", nullptr, 12_pt, 100_dpi), nullptr);
+            cache.insert_text("c", nullptr, 12_pt, 100_dpi, shaped_text());
+            CHECK_EQ(cache.size(), 2);
+            CHECK_NE(cache.find_text("a", nullptr, 12_pt, 100_dpi), nullptr);
+            CHECK_EQ(cache.find_text("b", nullptr, 12_pt, 100_dpi), nullptr);
+            CHECK_NE(cache.find_text("c", nullptr, 12_pt, 100_dpi), nullptr);
+        }
+
+        TEST_CASE("zero capacity disables the text cache")
+        {
+            auto cache = shaping_cache(0);
+            cache.insert_text("a", nullptr, 12_pt, 100_dpi, shaped_text());
+            CHECK_EQ(cache.size(), 0);
+            CHECK_EQ(cache.find_text("a", nullptr, 12_pt, 100_dpi), nullptr);
+        }
+
+        TEST_CASE("formulas are kept apart from texts")
+        {
+            auto cache = shaping_cache(4);
+            cache.insert_formula("$x$", 12_pt, 100_dpi, shaped_text());
+            CHECK_NE(cache.find_formula("$x$", 12_pt, 100_dpi), nullptr);
+            CHECK_EQ(cache.find_formula("$x$", 12_pt, 72_dpi), nullptr);
+            CHECK_EQ(cache.find_text("$x$", nullptr, 12_pt, 100_dpi), nullptr);
+            CHECK_EQ(cache.formula_statistics().hits, 1);
+            CHECK_EQ(cache.formula_statistics().misses, 1);
+            CHECK_EQ(cache.text_statistics().misses, 1);
+        }
+
+        TEST_CASE("vertical extents")
+        {
+            auto cache = shaping_cache(0);
+            CHECK_FALSE(cache.find_vertical_extent(nullptr, 12_pt, 100_dpi).has_value());
+            cache.insert_vertical_extent(nullptr, 12_pt, 100_dpi, 15_px);
+            CHECK_EQ(cache.find_vertical_extent(nullptr, 12_pt, 100_dpi), 15_px);
+            CHECK_EQ(cache.vertical_extent_statistics().hits, 1);
+            CHECK_EQ(cache.vertical_extent_statistics().misses, 1);
+        }
+
+        TEST_CASE("faces")
+        {
+            auto cache = shaping_cache(0);
+            auto face = freetype::face_t{};
+            const auto bold = font_properties{.weight = font_weights::bold};
+            CHECK_EQ(cache.find_face(bold, 12_pt), nullptr);
+            cache.insert_face(bold, 12_pt, &face);
+            CHECK_EQ(cache.find_face(bold, 12_pt), &face);
+            CHECK_EQ(cache.find_face(bold, 14_pt), nullptr);
+            CHECK_EQ(cache.find_face(font_properties{}, 12_pt), nullptr);
+            CHECK_EQ(cache.face_statistics().hits, 1);
+            CHECK_EQ(cache.face_statistics().misses, 3);
+        }
+
+        TEST_CASE("clear")
+        {
+            auto cache = shaping_cache(4);
+            cache.insert_text("a", nullptr, 12_pt, 100_dpi, shaped_text());
+            cache.clear();
+            CHECK_EQ(cache.size(), 0);
+            CHECK_EQ(cache.text_statistics().hits, 0);
+            CHECK_EQ(cache.text_statistics().misses, 0);
+        }
+    }
+}
@@ -6,6 +6,36 @@ namespace cdv::fnt
 {
     using namespace units_literals;
 
+    namespace
+    {
+        std::vector<shaped_glyph> shape_with_harfbuzz(const std::string& text, freetype::face_t* face)
+        {
+            auto* buffer = hb_buffer_create();
+            hb_buffer_set_direction(buffer, HB_DIRECTION_LTR);
+            hb_buffer_set_script(buffer, HB_SCRIPT_LATIN);
+            hb_buffer_set_language(buffer, hb_language_from_string("en", -1));
+            hb_buffer_add_utf8(buffer, text.c_str(), static_cast<int>(text.length()), 0,
+                               static_cast<int>(text.length()));
+            hb_shape(freetype::hb_font(face), buffer, nullptr, 0);
+
+            unsigned int num_glyphs = 0;
+            const auto* glyph_pos = hb_buffer_get_glyph_positions(buffer, &num_glyphs);
+            const auto* glyph_info = hb_buffer_get_glyph_infos(buffer, &num_glyphs);
+
+            auto x = 0_px;
+            std::vector<shaped_glyph> result(num_glyphs);
+            for (auto i = 0u; i < num_glyphs; ++i)
+            {
+                result[i].index = glyph_info[i].codepoint;
+                result[i].pos = {x + pixels(glyph_pos[i].x_offset / 64.0), pixels(-glyph_pos[i].y_offset / 64.0)};
+                x += pixels(glyph_pos[i].x_advance / 64.0);
+            }
+
+            hb_buffer_destroy(buffer);
+            return result;
+        }
+    }
+
     TEST_SUITE("text shaper")
     {
         TEST_CASE("simple text")
@@ -43,27 +73,38 @@ namespace cdv::fnt
         {
             const auto s = text_shaper();
             const auto result = s.shape(R"($\frac{1}{x^2}$)", 12_pt, 100_dpi).runs();
-            CHECK_EQ(result.size(), 3);
+            CHECK_EQ(result.size(), 2);
             CHECK_EQ(result[0].font_size, 12_pt);
-            CHECK_EQ(result[0].glyphs.size(), 1);
+            CHECK_EQ(result[0].glyphs.size(), 2);
             CHECK_EQ(result[0].lines.size(), 1);
+            CHECK_LT(result[1].font_size, 12_pt);
             CHECK_EQ(result[1].glyphs.size(), 1);
             CHECK(result[1].lines.empty());
-            CHECK_EQ(result[2].glyphs.size(), 1);
-            CHECK(result[2].lines.empty());
         }
 
         TEST_CASE("mathematical formula text with size variants")
         {
             const auto s = text_shaper();
             const auto result = s.shape(R"($\binom{n}{k}$)", 12_pt, 100_dpi).runs();
-            CHECK_EQ(result.size(), 4);
+            auto num_glyphs = size_t(0);
             for (const auto& r : result)
             {
                 CHECK_EQ(r.font_size, 12_pt);
-                CHECK_EQ(r.glyphs.size(), 1);
                 CHECK_EQ(r.lines.size(), 0);
+                num_glyphs += r.glyphs.size();
             }
+
+            CHECK_EQ(num_glyphs, 4);
+        }
+
+        TEST_CASE("adjacent formula glyphs with the same face and size share a run")
+        {
+            const auto s = text_shaper();
+            const auto result = s.shape("$10^{-12}$", 12_pt, 100_dpi).runs();
+            REQUIRE_EQ(result.size(), 2);
+            CHECK_EQ(result[0].glyphs.size(), 2);
+            CHECK_EQ(result[1].glyphs.size(), 3);
+            CHECK_GT(result[0].font_size, result[1].font_size);
         }
 
         TEST_CASE("mixed text")
@@ -79,5 +120,101 @@ namespace cdv::fnt
             CHECK_EQ(result[2].glyphs.size(), 1);
             CHECK(result[2].lines.empty());
         }
+
+        TEST_CASE("repeated text is served from the cache")
+        {
+            const auto context = std::make_shared<font_context>();
+            const auto s = text_shaper(context);
+            const auto result0 = s.shape("shape me", 12_pt, 100_dpi);
+            const auto result1 = s.shape("shape me", 12_pt, 100_dpi);
+            CHECK_EQ(result0.extents(), result1.extents());
+            CHECK_EQ(result0.runs().size(), result1.runs().size());
+            CHECK_EQ(context->cache().text_statistics().misses, 1);
+            CHECK_EQ(context->cache().text_statistics().hits, 1);
+
+            (void)s.shape("shape me", 14_pt, 100_dpi);
+            CHECK_EQ(context->cache().text_statistics().misses, 2);
+        }
+
+        TEST_CASE("formula layouts are reused within other texts")
+        {
+            const auto context = std::make_shared<font_context>();
+            const auto s = text_shaper(context);
+            const auto formula = s.shape("$10^{3}$", 12_pt, 100_dpi);
+            const auto mixed = s.shape("a $10^{3}$", 12_pt, 100_dpi);
+            CHECK_EQ(context->cache().formula_statistics().misses, 1);
+            CHECK_EQ(context->cache().formula_statistics().hits, 1);
+
+            REQUIRE_EQ(mixed.runs().size(), formula.runs().size() + 1);
+            const auto offset = mixed.runs()[1].glyphs[0].pos.x - formula.runs()[0].glyphs[0].pos.x;
+            CHECK_GT(offset, 0_px);
+            CHECK_EQ(mixed.runs()[1].glyphs[0].pos.y, formula.runs()[0].glyphs[0].pos.y);
+        }
+
+        TEST_CASE("numeric labels are laid out like fully shaped text")
+        {
+            const auto context = std::make_shared<font_context>();
+            const auto s = text_shaper(context);
+            for (const std::string label : {"0", "1.25", "-10", "1e+06", "2024.75", "-0.001", "77"})
+            {
+                const auto before = context->cache().shaping_statistics();
+                const auto runs = s.shape(label, 12_pt, 100_dpi).runs();
+                REQUIRE_EQ(runs.size(), 1);
+
+                // the default face can be described by the table, so HarfBuzz isn't used for the label
+                const auto lock = s.context()->lock();
+                const auto* table = context->cache().find_numeric_glyphs(runs[0].freetype_face, 12_pt, 100_dpi);
+                REQUIRE(table != nullptr);
+                CHECK(table->usable);
+                CHECK_EQ(context->cache().shaping_statistics().numeric, before.numeric + 1);
+                CHECK_EQ(context->cache().shaping_statistics().harfbuzz, before.harfbuzz);
+
+                freetype::set_size(runs[0].freetype_face, 12_pt, 100_dpi);
+                const auto expected = shape_with_harfbuzz(label, runs[0].freetype_face);
+                REQUIRE_EQ(runs[0].glyphs.size(), expected.size());
+                for (auto i = 0u; i < expected.size(); ++i)
+                {
+                    CHECK_EQ(runs[0].glyphs[i].index, expected[i].index);
+                    CHECK_EQ(runs[0].glyphs[i].pos, expected[i].pos);
+                }
+            }
+        }
+
+        TEST_CASE("texts that aren't numeric are shaped by harfbuzz")
+        {
+            const auto context = std::make_shared<font_context>();
+            const auto s = text_shaper(context);
+            const auto before = context->cache().shaping_statistics();
+            static_cast<void>(s.shape("x = 1.25", 12_pt, 100_dpi));
+            CHECK_EQ(context->cache().shaping_statistics().numeric, before.numeric);
+            CHECK_EQ(context->cache().shaping_statistics().harfbuzz, before.harfbuzz + 1);
+        }
+
+        TEST_CASE("selected faces are served from the cache")
+        {
+            const auto context = std::make_shared<font_context>();
+            auto s0 = text_shaper(context);
+            auto s1 = text_shaper(context);
+            CHECK_EQ(context->cache().face_statistics().misses, 1);
+            CHECK_EQ(context->cache().face_statistics().hits, 1);
+
+            s0.select_face({.weight = font_weights::bold}, 12_pt);
+            s1.select_face({.weight = font_weights::bold}, 12_pt);
+            CHECK_EQ(context->cache().face_statistics().misses, 2);
+            CHECK_EQ(context->cache().face_statistics().hits, 2);
+            CHECK_EQ(s0.shape("a", 12_pt, 100_dpi).runs()[0].freetype_face,
+                     s1.shape("a", 12_pt, 100_dpi).runs()[0].freetype_face);
+        }
+
+        TEST_CASE("vertical extent")
+        {
+            const auto context = std::make_shared<font_context>();
+            const auto s = text_shaper(context);
+            const auto extent = s.vertical_extent(12_pt, 100_dpi);
+            CHECK_EQ(extent, s.shape("My", 12_pt, 100_dpi).extents().y);
+            CHECK_EQ(s.vertical_extent(12_pt, 100_dpi), extent);
+            CHECK_EQ(context->cache().vertical_extent_statistics().misses, 1);
+            CHECK_EQ(context->cache().vertical_extent_statistics().hits, 1);
+        }
     }
 }
\ No newline at end of file
@@ -11,6 +11,7 @@
 
 #include <initializer_list>
 #include <string>
+#include <utility>
 
 namespace cdv::test
 {
@@ -42,6 +43,11 @@ namespace cdv::test
             return {};
         }
 
+        // like the back ends, the clip rect is set with its origin and extents and reported as its min and max
+        void set_clip_rect(const pixel_pos origin, const pixel_pos extents) { clip_rect_ = {origin, origin + extents}; }
+        void unset_clip_rect() { clip_rect_ = no_clip_rect(); }
+        [[nodiscard]] std::pair<pixel_pos, pixel_pos> get_clip_rect() const { return clip_rect_; }
+
         [[nodiscard]] pixels to_pixels(const points p) const { return mfl::points_to_pixels(p, dots_per_inch{100.0}); }
 
         [[nodiscard]] size_t set_color_counter() const { return set_color_counter_; }
@@ -60,5 +66,11 @@ namespace cdv::test
         size_t stroke_counter_ = 0;
         size_t fill_counter_ = 0;
         size_t gradient_fill_counter_ = 0;
+        [[nodiscard]] static std::pair<pixel_pos, pixel_pos> no_clip_rect()
+        {
+            return {pixel_pos(pixels(-1e6), pixels(-1e6)), pixel_pos(pixels(1e6), pixels(1e6))};
+        }
+
+        std::pair<pixel_pos, pixel_pos> clip_rect_ = no_clip_rect();
     };
 }
\ No newline at end of file